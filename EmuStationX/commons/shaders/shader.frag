@@ -8,14 +8,17 @@ flat in uint oBPP;
 flat in uint oSemiTransparency;
 flat in uint oDither;
 flat in uint oRawTexture;
+flat in uvec2 oDrawTopLeft;
+flat in uvec2 oDrawBottomRight;
+flat in uint oForceAlpha;
+flat in uint oCheckMask;
 
 layout(binding=0) uniform sampler2D uVRAM;   
-
-uniform int uCheckMask;
-uniform int uForceAlpha;
+layout(binding=3) uniform sampler2D uTexturePages;
 
 out vec4 fragColor;
 
+#define BPP_CACHED 0u
 #define BPP_4 4u
 #define BPP_8 8u
 #define BPP_16 16u
@@ -135,35 +138,44 @@ vec4 blend_colors(vec4 background, vec4 foreground, uint blendFunc) {
 }
 
 void main() {
+    ivec2 vramCoords = ivec2(gl_FragCoord.x, 511 - int(gl_FragCoord.y));
+    if(any(lessThan(vramCoords, ivec2(oDrawTopLeft))) || any(greaterThan(vramCoords, ivec2(oDrawBottomRight)))) discard;
+
     vec4 color = vec4(oColor,1.0);
     vec4 previousColor = texelFetch(uVRAM,ivec2(gl_FragCoord.xy),0);
 
-    if(uCheckMask == 1 && previousColor.a == 1) discard;
+    if(oCheckMask == 1u && previousColor.a == 1) discard;
 
     ivec2 iUV = ivec2(oUV.x, oUV.y);
     ivec2 iClutUV = ivec2(oClutUV.x, oClutUV.y);
 
     if(oTextured == 1) {
-        ivec2 uvColor = ivec2(0,0);
-
-        switch (oBPP) {
-            case BPP_4: {
-                uvColor = ivec2(iClutUV.x + texel_4bit(iUV),511 - iClutUV.y);  
-                break;
-            }
-
-            case BPP_8: {
-                uvColor = ivec2(iClutUV.x + texel_8bit(iUV),511 - iClutUV.y);  
-                break;
+        if (oBPP == BPP_CACHED) {
+            //Pre-decoded page, the clut coordinates hold the page origin in the cache texture
+            color = texelFetch(uTexturePages, iClutUV + (iUV & ivec2(255)), 0);
+        } else {
+            ivec2 uvColor = ivec2(0,0);
+
+            switch (oBPP) {
+                case BPP_4: {
+                    uvColor = ivec2(iClutUV.x + texel_4bit(iUV),511 - iClutUV.y);  
+                    break;
+                }
+
+                case BPP_8: {
+                    uvColor = ivec2(iClutUV.x + texel_8bit(iUV),511 - iClutUV.y);  
+                    break;
+                }
+
+                case BPP_16: {
+                    uvColor = ivec2(iUV.x, 511 - iUV.y);
+                    break;
+                }
             }
 
-            case BPP_16: {
-                uvColor = ivec2(iUV.x, 511 - iUV.y);
-                break;
-            }
+            color = sample_vram(uvColor);
         }
-       
-        color = sample_vram(uvColor);
+
         if(color == vec4(0,0,0,0)) discard;
         if(oRawTexture == 0u) {
             color = (color * vec4(oColor,1.0)) / (128.0 / 255.0);
@@ -188,7 +200,7 @@ void main() {
         color = blend_colors(previousColor, color, oSemiTransparency);
     }
 
-    if(uForceAlpha == 1) {
+    if(oForceAlpha == 1u) {
         color.a = 1;
     }
 
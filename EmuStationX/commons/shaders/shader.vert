@@ -9,6 +9,10 @@ layout(location = 5) in uint aBPP;
 layout(location = 6) in uint aSemiTransparency;
 layout(location = 7) in uint aDither;
 layout(location = 8) in uint aRawTexture;
+layout(location = 9) in uvec2 aDrawTopLeft;
+layout(location = 10) in uvec2 aDrawBottomRight;
+layout(location = 11) in uint aForceAlpha;
+layout(location = 12) in uint aCheckMask;
 
 out vec3 oColor;
 out vec2 oUV;
@@ -18,6 +22,10 @@ flat out uint oBPP;
 flat out uint oSemiTransparency;
 flat out uint oDither;
 flat out uint oRawTexture;
+flat out uvec2 oDrawTopLeft;
+flat out uvec2 oDrawBottomRight;
+flat out uint oForceAlpha;
+flat out uint oCheckMask;
 
 vec2 mapPointToRange(vec2 point, vec2 topLeft, vec2 bottomRight) {
     vec2 range = bottomRight - topLeft;
@@ -49,4 +57,8 @@ void main() {
     oSemiTransparency = aSemiTransparency;
     oDither = aDither;
     oRawTexture = aRawTexture;
+    oDrawTopLeft = aDrawTopLeft;
+    oDrawBottomRight = aDrawBottomRight;
+    oForceAlpha = aForceAlpha;
+    oCheckMask = aCheckMask;
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#version 450 core
+
+layout(binding=0) uniform sampler2D uVRAM;
+
+uniform ivec2 uPage;
+uniform ivec2 uClut;
+uniform int uBPP;
+uniform ivec2 uSlot;
+
+out vec4 fragColor;
+
+int float_5bit(float value) {
+    return int(round(value * 31.0));
+}
+
+vec4 sample_vram(ivec2 coords) {
+    coords &= ivec2(1023,511);
+    return texelFetch(uVRAM, coords, 0);
+}
+
+int sample_16bit(ivec2 coords) {
+    vec4 color = sample_vram(coords);
+
+    int r = float_5bit(color.r);
+    int g = float_5bit(color.g);
+    int b = float_5bit(color.b);
+    int a = int(ceil(color.a));
+
+    int data = (a << 15) | (b << 10) | (g << 5) | (r);
+
+    return data;
+}
+
+int texel_8bit(ivec2 coords) {
+    ivec2 vram_coords = ivec2(coords.x >> 1,511 - coords.y);
+    int data = sample_16bit(vram_coords);
+    int shift = (coords.x & 1) << 3;
+    int texel = (data >> shift) & 0xFF;
+    return texel;
+}
+
+int texel_4bit(ivec2 coords) {
+    ivec2 vram_coords = ivec2(coords.x >> 2,511 - coords.y);
+    int data = sample_16bit(vram_coords);
+    int shift = (coords.x & 3) << 2;
+    int texel = (data >> shift) & 0xF;
+    return texel;
+}
+
+void main() {
+    //Texel (u,v) of the page lands at uSlot + (u,v) in the cache texture
+    ivec2 iUV = uPage + ivec2(gl_FragCoord.xy) - uSlot;
+
+    int texel = (uBPP == 4) ? texel_4bit(iUV) : texel_8bit(iUV);
+
+    fragColor = sample_vram(ivec2(uClut.x + texel, 511 - uClut.y));
+}
@@ -0,0 +1,7 @@
+#version 450 core
+
+void main() {
+    //Single triangle covering the viewport, the slot is selected with viewport and scissor
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(position * 2.0 - 1.0, 0, 1);
+}
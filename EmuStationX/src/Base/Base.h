@@ -3,6 +3,8 @@
 #include "PlatformDetection.h"
 
 #include <array>
+#include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <string>
 #include <format>
@@ -18,6 +20,8 @@
 #include <tuple>
 #include <filesystem>
 #include <mutex>
+#include <thread>
+#include <atomic>
 #include <span>
 #include <optional>
 
@@ -215,6 +219,85 @@ namespace esx {
 		size_t mReadIndex = 0;
 	};
 
+	//Preallocated ring, indices run freely and are masked on access
+	template<typename T, size_t Capacity>
+	class RingBuffer {
+		static_assert((Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+	public:
+		RingBuffer() = default;
+		~RingBuffer() = default;
+
+		BIT push_back(const T& data) {
+			if (full()) return ESX_FALSE;
+
+			mBuffer[mWriteIndex++ & MASK] = data;
+			return ESX_TRUE;
+		}
+
+		//Copies what fits and returns how much that was, anything beyond free() is dropped
+		size_t push_back(const T* data, size_t count) {
+			count = std::min(count, free());
+			for (size_t copied = 0; copied < count;) {
+				Span<T> span = write_span();
+				size_t chunk = std::min(count - copied, span.size());
+				std::copy_n(data + copied, chunk, span.data());
+				mWriteIndex += chunk;
+				copied += chunk;
+			}
+			return count;
+		}
+
+		size_t pop_front(T* output, size_t count) {
+			count = std::min(count, size());
+			for (size_t copied = 0; copied < count;) {
+				Span<const T> span = read_span();
+				size_t chunk = std::min(count - copied, span.size());
+				std::copy_n(span.data(), chunk, output + copied);
+				mReadIndex += chunk;
+				copied += chunk;
+			}
+			return count;
+		}
+
+		void pop_front(size_t count = 1) { mReadIndex += std::min(count, size()); }
+
+		T& front() { return mBuffer[mReadIndex & MASK]; }
+		T& back() { return mBuffer[(mWriteIndex - 1) & MASK]; }
+
+		//Contiguous runs up to the wrap point, commit with pop_front/commit
+		Span<const T> read_span() const {
+			size_t start = mReadIndex & MASK;
+			return Span<const T>(mBuffer.data() + start, std::min(size(), Capacity - start));
+		}
+
+		Span<T> write_span() {
+			size_t start = mWriteIndex & MASK;
+			return Span<T>(mBuffer.data() + start, std::min(free(), Capacity - start));
+		}
+
+		void commit(size_t count) { mWriteIndex += std::min(count, free()); }
+
+		//Only linear while nothing has been popped since the last clear
+		T* data() { return mBuffer.data(); }
+		const T* data() const { return mBuffer.data(); }
+
+		void clear() { mReadIndex = mWriteIndex = 0; }
+
+		inline size_t size() const { return mWriteIndex - mReadIndex; }
+		inline size_t free() const { return Capacity - size(); }
+		inline BIT empty() const { return size() == 0; }
+		inline BIT full() const { return size() == Capacity; }
+		static constexpr size_t capacity() { return Capacity; }
+
+	private:
+		static constexpr size_t MASK = Capacity - 1;
+
+		alignas(64) Array<T, Capacity> mBuffer = {};
+		size_t mWriteIndex = 0;
+		size_t mReadIndex = 0;
+	};
+
 
 #ifdef ESX_DEBUG
 #if defined(ESX_PLATFORM_WINDOWS)
@@ -16,18 +16,58 @@ namespace esx {
 
 		mTrackNumber = computeCurrentTrack();
 
-		mCurrentFile->mStream.seekg(seekPos - (mCurrentFile->Start - calculateBinaryPosition(0, 2, 0)), mCurrentFile->mStream.beg);
+		U64 offset = getFileOffset();
+		if (mCurrentFile->Mapping) {
+			mCurrentFile->Mapping->WillNeed(offset);
+		} else {
+			mCurrentFile->mStream.seekg(offset, mCurrentFile->mStream.beg);
+		}
 	}
 
 	void CDRWIN::readSector(Sector* pOutSector)
 	{
-		mCurrentFile->mStream.read(reinterpret_cast<char*>(pOutSector), sizeof(Sector));
-		if (mCurrentFile->mStream.fail() == ESX_TRUE) {
-			ESX_CORE_LOG_TRACE("Strano");
+		const Sector* sector = readSectorView(pOutSector);
+		if (sector != pOutSector) {
+			*pOutSector = *sector;
+		}
+	}
+
+	const Sector* CDRWIN::readSectorView(Sector* pScratch)
+	{
+		const Sector* sector = pScratch;
+
+		U64 offset = getFileOffset();
+		if (mCurrentFile->Mapping) {
+			U64 size = mCurrentFile->Mapping->GetSize();
+			if (offset + sizeof(Sector) <= size) {
+				sector = reinterpret_cast<const Sector*>(mCurrentFile->Mapping->GetData() + offset);
+				mCurrentFile->Mapping->WillNeed(offset);
+			} else {
+				//Truncated BIN, whatever is left of the sector is kept and the rest reads as zeros
+				ESX_CORE_LOG_ERROR("CDRWIN - Sector at offset {} runs past the end of the file", offset);
+				U64 available = (offset < size) ? (size - offset) : 0;
+				if (available > 0) {
+					std::memcpy(pScratch, mCurrentFile->Mapping->GetData() + offset, available);
+				}
+				std::memset(reinterpret_cast<U8*>(pScratch) + available, 0, sizeof(Sector) - available);
+			}
+		} else {
+			mCurrentFile->mStream.read(reinterpret_cast<char*>(pScratch), sizeof(Sector));
+			if (mCurrentFile->mStream.fail() == ESX_TRUE) {
+				ESX_CORE_LOG_TRACE("Strano");
+			}
 		}
 		mCurrentLBA += sizeof(Sector);
 
+		auto previousFile = mCurrentFile;
 		mTrackNumber = computeCurrentTrack();
+
+		//Sequential reads can run into the next BIN file, its stream has to continue from the right place
+		if (mCurrentFile != previousFile && !mCurrentFile->Mapping) {
+			mCurrentFile->mStream.seekg(getFileOffset(), mCurrentFile->mStream.beg);
+		}
+
+		return sector;
 	}
 
 	U8 CDRWIN::getLastTrack()
@@ -42,16 +82,17 @@ namespace esx {
 			return fromBinaryPositionToMSF(mFiles[mFiles.size() - 1].End);
 		}
 
-		auto trackFile = getFileByTrackNumber(trackNumber);
-		if (trackFile != mFiles.end()) {
-			auto track = std::find_if(trackFile->Tracks.begin(), trackFile->Tracks.end(), [&](const CDRWINTrack& track) { return track.Number == trackNumber; });
-			
-			U32 trackIndexLBA = track->Indexes[0].lba + track->Indexes[0].pregapLba;
-			if (track->Indexes.size() > 1 && useIndex1) {
-				trackIndexLBA = track->Indexes[1].lba + track->Indexes[1].pregapLba;
+		auto trackEntry = mTrackTable.find(trackNumber);
+		if (trackEntry != mTrackTable.end()) {
+			const CDRWinFile& trackFile = mFiles[trackEntry->second.first];
+			const CDRWINTrack& track = trackFile.Tracks[trackEntry->second.second];
+
+			U32 trackIndexLBA = track.Indexes[0].lba + track.Indexes[0].pregapLba;
+			if (track.Indexes.size() > 1 && useIndex1) {
+				trackIndexLBA = track.Indexes[1].lba + track.Indexes[1].pregapLba;
 			}
 
-			return fromBinaryPositionToMSF(trackFile->Start + trackIndexLBA);
+			return fromBinaryPositionToMSF(trackFile.Start + trackIndexLBA);
 		}
 
 		return {};
@@ -59,53 +100,101 @@ namespace esx {
 
 	Vector<CDRWinFile>::iterator CDRWIN::computeFile(U64 lba)
 	{
-		return std::find_if(mFiles.begin(), mFiles.end(), [&](const CDRWinFile& file) { return lba >= file.Start && lba < file.End; });
+		U32 interval = findInterval(lba);
+		return (interval != NO_INTERVAL) ? mFiles.begin() + mIntervals[interval].File : mFiles.end();
 	}
 
 	Vector<CDRWinFile>::iterator esx::CDRWIN::getFileByTrackNumber(U8 track)
 	{
-		auto foundIt = mFiles.end();
-
-		for (auto it = mFiles.begin(); it < mFiles.end(); ++it) {
-			auto foundTrack = std::find_if(it->Tracks.begin(), it->Tracks.end(), [&](const CDRWINTrack& fileTrack) { return fileTrack.Number == track; });
-			if (foundTrack != it->Tracks.end()) {
-				foundIt = it;
-				break;
-			}
-		}
-
-		return foundIt;
+		auto trackEntry = mTrackTable.find(track);
+		return (trackEntry != mTrackTable.end()) ? mFiles.begin() + trackEntry->second.first : mFiles.end();
 	}
 
 	U64 CDRWIN::computeGapLBA()
 	{
-		for (CDRWINTrack& track : mCurrentFile->Tracks) {
-			for (CDRWinIndex& index : track.Indexes) {
-				if ((mCurrentLBA - calculateBinaryPosition(0, 2, 0)) >= (index.lba + index.pregapLba)) {
-					return index.pregapLba - calculateBinaryPosition(0, 2, 0);
-				}
-			}
-		}
+		U32 interval = findInterval(mCurrentLBA);
+		return (interval != NO_INTERVAL) ? mIntervals[interval].PregapLba - calculateBinaryPosition(0, 2, 0) : 0;
 	}
 
 	U8 CDRWIN::computeCurrentTrack()
 	{
-		mCurrentFile = computeFile(mCurrentLBA);
-		if (mCurrentFile == mFiles.end()) {
+		U32 interval = findInterval(mCurrentLBA);
+		if (interval == NO_INTERVAL) {
 			ESX_CORE_LOG_ERROR("LBA greater than track size");
-			mCurrentFile = mFiles.begin() + 1;
+			mCurrentFile = mFiles.begin() + std::min<size_t>(1, mFiles.size() - 1);
 			mCurrentLBA = mCurrentFile->Start + calculateBinaryPosition(0, 2, 0);
+
+			interval = findInterval(mCurrentLBA);
+			if (interval == NO_INTERVAL) return 0;
 		}
 
-		for (auto it = mCurrentFile->Tracks.begin(); it < mCurrentFile->Tracks.end();++it) {
-			for (CDRWinIndex& index : it->Indexes) {
-				if (mCurrentLBA >= (mCurrentFile->Start + index.lba + index.pregapLba)) {
-					mCurrentTrack = it;
-					return it->Number;
+		const CDRWinInterval& current = mIntervals[interval];
+		mCurrentFile = mFiles.begin() + current.File;
+		mCurrentTrack = mCurrentFile->Tracks.begin() + current.Track;
+		return mCurrentTrack->Number;
+	}
+
+	U32 CDRWIN::findInterval(U64 lba)
+	{
+		auto contains = [&](U32 interval) {
+			return interval < mIntervals.size() && lba >= mIntervals[interval].Start && lba < mIntervals[interval].End;
+		};
+
+		//Sequential reads stay in the current interval or step into the next one
+		if (contains(mCurrentInterval)) return mCurrentInterval;
+		if (contains(mCurrentInterval + 1)) return ++mCurrentInterval;
+
+		auto next = std::upper_bound(mIntervals.begin(), mIntervals.end(), lba, [](U64 lba, const CDRWinInterval& interval) { return lba < interval.Start; });
+		if (next == mIntervals.begin()) return NO_INTERVAL;
+
+		U32 interval = static_cast<U32>(next - mIntervals.begin()) - 1;
+		if (!contains(interval)) return NO_INTERVAL;
+
+		mCurrentInterval = interval;
+		return interval;
+	}
+
+	void CDRWIN::compileIntervals()
+	{
+		mIntervals.clear();
+		mTrackTable.clear();
+
+		for (U32 fileIndex = 0; fileIndex < mFiles.size(); fileIndex++) {
+			const CDRWinFile& file = mFiles[fileIndex];
+			size_t first = mIntervals.size();
+
+			for (U32 trackIndex = 0; trackIndex < file.Tracks.size(); trackIndex++) {
+				const CDRWINTrack& track = file.Tracks[trackIndex];
+				mTrackTable[track.Number] = { fileIndex, trackIndex };
+
+				for (U32 indexIndex = 0; indexIndex < track.Indexes.size(); indexIndex++) {
+					const CDRWinIndex& index = track.Indexes[indexIndex];
+
+					CDRWinInterval& interval = mIntervals.emplace_back();
+					interval.Start = std::clamp<U64>(file.Start + index.lba + index.pregapLba, file.Start, file.End);
+					interval.File = fileIndex;
+					interval.Track = trackIndex;
+					interval.Index = indexIndex;
+					interval.PregapLba = index.pregapLba;
 				}
 			}
+
+			auto begin = mIntervals.begin() + first;
+			if (begin == mIntervals.end()) continue;
+
+			std::stable_sort(begin, mIntervals.end(), [](const CDRWinInterval& a, const CDRWinInterval& b) { return a.Start < b.Start; });
+
+			//Whatever precedes the first index still belongs to the file's first track
+			begin->Start = file.Start;
+			for (auto it = begin; it != mIntervals.end(); ++it) {
+				it->End = (it + 1 != mIntervals.end()) ? (it + 1)->Start : file.End;
+				it->FileOffset = it->Start - file.Start;
+			}
+
+			mIntervals.erase(std::remove_if(begin, mIntervals.end(), [](const CDRWinInterval& interval) { return interval.Start == interval.End; }), mIntervals.end());
 		}
-		return 0;
+
+		mCurrentInterval = 0;
 	}
 
 	void CDRWIN::parse(const std::filesystem::path& cuePath)
@@ -125,7 +214,12 @@ namespace esx {
 				CDRWinFile& file = mFiles.emplace_back();
 				iss >> std::quoted(file.FileName);
 				auto filePath = cuePath.parent_path() / file.FileName;
-				file.mStream.open(filePath, std::ios::binary);
+				file.Mapping = MakeScoped<platform::MappedFile>(filePath);
+				if (!file.Mapping->IsOpen()) {
+					file.Mapping.reset();
+					file.mStream.open(filePath, std::ios::binary);
+					mMapped = ESX_FALSE;
+				}
 				file.Start = ((mFiles.size() == 1) ? calculateBinaryPosition(0,2,0) : mFiles[mFiles.size() - 2].End);
 				file.End = file.Start + std::filesystem::file_size(filePath);
 			} else if (token == "TRACK") {
@@ -181,6 +275,7 @@ namespace esx {
 		}
 
 		mCurrentFile = mFiles.end();
+		compileIntervals();
 
 		cueFile.close();
 	}
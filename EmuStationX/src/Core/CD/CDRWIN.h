@@ -7,6 +7,8 @@
 
 #include "CompactDisk.h"
 
+#include "Platform/Win32/MappedFile.h"
+
 namespace esx {
 
 	enum class CDRWINTrackMode {
@@ -39,9 +41,21 @@ namespace esx {
 		U64 Start = 0;
 		U64 End = 0;
 		FileInputStream mStream = {};
+		ScopedPtr<platform::MappedFile> Mapping = {};
 		Vector<CDRWINTrack> Tracks = {};
 	};
 
+	//Span of the disc covered by one index of one track, compiled from the CUE sheet at parse time
+	struct CDRWinInterval {
+		U64 Start = 0;
+		U64 End = 0;
+		U32 File = 0;
+		U32 Track = 0;
+		U32 Index = 0;
+		U64 PregapLba = 0;
+		U64 FileOffset = 0;
+	};
+
 	class CDRWIN : public CompactDisk {
 	public:
 		CDRWIN(const std::filesystem::path& cuePath);
@@ -49,9 +63,12 @@ namespace esx {
 
 		virtual void seek(U64 seekPos) override;
 		virtual void readSector(Sector* pOutSector) override;
+		virtual const Sector* readSectorView(Sector* pScratch) override;
 		virtual U8 getLastTrack() override;
 		virtual MSF getTrackStart(U8 trackNumber, BIT useIndex1 = ESX_FALSE) override;
 		virtual BIT isAudioTrack() { return mCurrentTrack->AudioTrack; }
+		virtual BIT providesSectorViews() override { return mMapped; }
+		virtual U64 getEndPos() override { return mFiles.back().End - sizeof(Sector); }
 
 		Vector<CDRWinFile>::iterator computeFile(U64 lba);
 		Vector<CDRWinFile>::iterator getFileByTrackNumber(U8 track);
@@ -60,12 +77,24 @@ namespace esx {
 
 	private:
 		void parse(const std::filesystem::path& cuePath);
+		void compileIntervals();
+		U32 findInterval(U64 lba);
+		U64 getFileOffset() const { return mIntervals[mCurrentInterval].FileOffset + (mCurrentLBA - mIntervals[mCurrentInterval].Start); }
+
+	private:
+		static constexpr U32 NO_INTERVAL = UINT32_MAX;
 
 	private:
 		StringView mCuePath;
 		Vector<CDRWinFile> mFiles;
+		BIT mMapped = ESX_TRUE;
 		Vector<CDRWinFile>::iterator mCurrentFile;
 		Vector<CDRWINTrack>::iterator mCurrentTrack;
+
+		//Sorted by Start, sequential reads stay within or move to the next interval
+		Vector<CDRWinInterval> mIntervals;
+		U32 mCurrentInterval = 0;
+		UnorderedMap<U8, Pair<U32, U32>> mTrackTable;
 	};
 
 }
\ No newline at end of file
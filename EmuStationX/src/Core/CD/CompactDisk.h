@@ -12,12 +12,18 @@ namespace esx {
 
 		virtual void seek(U64 seekPos) = 0;
 		virtual void readSector(Sector* pOutSector) = 0;
+		//Zero copy read. Disks that cannot hand out a view of their own storage read into pScratch and return it.
+		virtual const Sector* readSectorView(Sector* pScratch) { readSector(pScratch); return pScratch; }
 		virtual U8 getLastTrack() = 0;
 		virtual MSF getTrackStart(U8 trackNumber, BIT useIndex1 = ESX_FALSE) = 0;
 		virtual Optional<SubchannelQ> getCurrentSubChannelQ() { return {}; }
 
 		virtual U64 getCurrentPos() { return mCurrentLBA; }
+		//First position that does not read back cleanly, read-ahead stops there
+		virtual U64 getEndPos() { return UINT64_MAX; }
 		virtual BIT isAudioTrack() { return ESX_FALSE; }
+		//True when readSectorView returns views that stay valid as long as the disk is alive
+		virtual BIT providesSectorViews() { return ESX_FALSE; }
 
 		U8 getTrackNumber() { return mTrackNumber; }
 
@@ -0,0 +1,226 @@
+#include "CompressedDisc.h"
+
+#include "CDRWIN.h"
+
+#include "Utils/BlockCompression.h"
+
+namespace esx {
+
+	constexpr U32 FIRST_SECTOR = calculateBinaryPosition(0, 2, 0) / CD_SECTOR_SIZE;
+
+	static U32 toSector(const MSF& msf)
+	{
+		return calculateBinaryPosition(msf.Minute, msf.Second, msf.Sector) / CD_SECTOR_SIZE;
+	}
+
+	CompressedDisc::CompressedDisc(const std::filesystem::path& filePath)
+	{
+		mStream.open(filePath, std::ios::binary);
+		mStream.read(reinterpret_cast<char*>(&mHeader), sizeof(CompressedDiscHeader));
+		if (mStream.fail() || mHeader.Magic != MAGIC || mHeader.Version != VERSION || mHeader.HunkSectors == 0) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - {} is not a compressed disc image", filePath.string());
+			return;
+		}
+
+		mTracks.resize(mHeader.NumTracks);
+		mStream.read(reinterpret_cast<char*>(mTracks.data()), mTracks.size() * sizeof(CompressedDiscTrack));
+
+		U32 numHunks = (mHeader.NumSectors + mHeader.HunkSectors - 1) / mHeader.HunkSectors;
+		mHunkOffsets.resize(numHunks + 1);
+		mStream.seekg(mHeader.IndexOffset, mStream.beg);
+		mStream.read(reinterpret_cast<char*>(mHunkOffsets.data()), mHunkOffsets.size() * sizeof(U64));
+		if (mStream.fail()) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - {} is truncated", filePath.string());
+			return;
+		}
+
+		U32 hunkSize = mHeader.HunkSectors * CD_SECTOR_SIZE;
+		mCompressed.resize(hunkSize);
+		for (CachedHunk& hunk : mCache) {
+			hunk.Data.resize(hunkSize);
+		}
+
+		mOpen = ESX_TRUE;
+	}
+
+	void CompressedDisc::seek(U64 seekPos)
+	{
+		mCurrentLBA = seekPos;
+
+		computeCurrentTrack();
+	}
+
+	void CompressedDisc::readSector(Sector* pOutSector)
+	{
+		U64 sector = mCurrentLBA / CD_SECTOR_SIZE;
+		if (sector < FIRST_SECTOR || (sector - FIRST_SECTOR) >= mHeader.NumSectors) {
+			ESX_CORE_LOG_ERROR("LBA Greater than file size");
+			return;
+		}
+
+		U32 index = static_cast<U32>(sector - FIRST_SECTOR);
+		const U8* hunk = getHunk(index / mHeader.HunkSectors);
+		if (hunk == nullptr) return;
+
+		std::memcpy(pOutSector, hunk + (index % mHeader.HunkSectors) * CD_SECTOR_SIZE, sizeof(Sector));
+		mCurrentLBA += sizeof(Sector);
+
+		computeCurrentTrack();
+	}
+
+	U8 CompressedDisc::getLastTrack()
+	{
+		return mTracks.empty() ? 0 : mTracks.back().Number;
+	}
+
+	MSF CompressedDisc::getTrackStart(U8 trackNumber, BIT useIndex1)
+	{
+		if (trackNumber == 0) {
+			return fromBinaryPositionToMSF(mHeader.LeadOut * CD_SECTOR_SIZE);
+		}
+
+		auto track = std::find_if(mTracks.begin(), mTracks.end(), [&](const CompressedDiscTrack& track) { return track.Number == trackNumber; });
+		if (track != mTracks.end()) {
+			return fromBinaryPositionToMSF((useIndex1 ? track->Index1 : track->Start) * CD_SECTOR_SIZE);
+		}
+
+		return {};
+	}
+
+	const U8* CompressedDisc::getHunk(U32 hunk)
+	{
+		for (CachedHunk& cached : mCache) {
+			if (cached.Index == hunk) {
+				cached.LastUse = ++mUseCounter;
+				return cached.Data.data();
+			}
+		}
+
+		CachedHunk& victim = *std::min_element(mCache.begin(), mCache.end(), [](const CachedHunk& a, const CachedHunk& b) { return a.LastUse < b.LastUse; });
+		victim.Index = UINT32_MAX;
+
+		U64 offset = mHunkOffsets[hunk];
+		U64 size = mHunkOffsets[hunk + 1] - offset;
+		U32 rawSize = std::min(mHeader.HunkSectors, mHeader.NumSectors - hunk * mHeader.HunkSectors) * CD_SECTOR_SIZE;
+		if (size > mCompressed.size()) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - Hunk {} is corrupted", hunk);
+			return nullptr;
+		}
+
+		mStream.seekg(offset, mStream.beg);
+		mStream.read(reinterpret_cast<char*>(mCompressed.data()), size);
+		if (mStream.fail()) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - Unable to read hunk {}", hunk);
+			mStream.clear();
+			return nullptr;
+		}
+
+		//Hunks that did not shrink are stored as they are
+		if (size == rawSize) {
+			std::memcpy(victim.Data.data(), mCompressed.data(), rawSize);
+		} else if (!DecompressBlock(mCompressed.data(), static_cast<U32>(size), victim.Data.data(), rawSize)) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - Hunk {} is corrupted", hunk);
+			return nullptr;
+		}
+
+		victim.Index = hunk;
+		victim.LastUse = ++mUseCounter;
+		return victim.Data.data();
+	}
+
+	void CompressedDisc::computeCurrentTrack()
+	{
+		if (mTracks.empty()) return;
+
+		//Tracks are stored in disc order, the current one is the last that starts at or before the position
+		U64 sector = mCurrentLBA / CD_SECTOR_SIZE;
+		auto next = std::upper_bound(mTracks.begin(), mTracks.end(), sector, [](U64 sector, const CompressedDiscTrack& track) { return sector < track.Start; });
+		const CompressedDiscTrack& track = (next == mTracks.begin()) ? *next : *(next - 1);
+
+		mTrackNumber = track.Number;
+		mAudioTrack = track.AudioTrack;
+	}
+
+	BIT CompressedDisc::Convert(const std::filesystem::path& cuePath, const std::filesystem::path& outPath, U32 hunkSectors, std::atomic<F32>* pProgress)
+	{
+		if (!std::filesystem::exists(cuePath)) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - {} not found", cuePath.string());
+			return ESX_FALSE;
+		}
+
+		CDRWIN source(cuePath);
+
+		CompressedDiscHeader header = {};
+		header.Magic = MAGIC;
+		header.Version = VERSION;
+		header.HunkSectors = hunkSectors;
+		header.LeadOut = toSector(source.getTrackStart(0));
+		header.NumSectors = header.LeadOut - FIRST_SECTOR;
+		header.NumTracks = source.getLastTrack();
+
+		//The track layout is all the subchannel Q generation needs, the BIN files carry no subchannel data
+		Vector<CompressedDiscTrack> tracks(header.NumTracks);
+		for (U32 i = 0; i < header.NumTracks; i++) {
+			CompressedDiscTrack& track = tracks[i];
+			track.Number = i + 1;
+			track.Start = toSector(source.getTrackStart(track.Number));
+			track.Index1 = toSector(source.getTrackStart(track.Number, ESX_TRUE));
+
+			source.seek(static_cast<U64>(track.Index1) * CD_SECTOR_SIZE);
+			track.AudioTrack = source.isAudioTrack();
+		}
+
+		std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - Unable to open {}", outPath.string());
+			return ESX_FALSE;
+		}
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(CompressedDiscHeader));
+		out.write(reinterpret_cast<const char*>(tracks.data()), tracks.size() * sizeof(CompressedDiscTrack));
+
+		Vector<U8> raw(hunkSectors * CD_SECTOR_SIZE);
+		Vector<U8> packed(CompressBlockBound(static_cast<U32>(raw.size())));
+		Vector<U64> offsets = {};
+		U64 offset = sizeof(CompressedDiscHeader) + tracks.size() * sizeof(CompressedDiscTrack);
+
+		for (U32 first = 0; first < header.NumSectors; first += hunkSectors) {
+			U32 count = std::min(hunkSectors, header.NumSectors - first);
+			for (U32 i = 0; i < count; i++) {
+				source.seek(static_cast<U64>(FIRST_SECTOR + first + i) * CD_SECTOR_SIZE);
+				source.readSector(reinterpret_cast<Sector*>(&raw[i * CD_SECTOR_SIZE]));
+			}
+
+			U32 rawSize = count * CD_SECTOR_SIZE;
+			U32 size = CompressBlock(raw.data(), rawSize, packed.data(), static_cast<U32>(packed.size()));
+			const U8* data = packed.data();
+			if (size == 0 || size >= rawSize) {
+				data = raw.data();
+				size = rawSize;
+			}
+
+			offsets.push_back(offset);
+			out.write(reinterpret_cast<const char*>(data), size);
+			offset += size;
+
+			if (pProgress) pProgress->store(static_cast<F32>(first + count) / header.NumSectors);
+		}
+		offsets.push_back(offset);
+
+		header.IndexOffset = offset;
+		out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(U64));
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(CompressedDiscHeader));
+
+		if (out.fail()) {
+			ESX_CORE_LOG_ERROR("CompressedDisc - Failed writing {}", outPath.string());
+			return ESX_FALSE;
+		}
+
+		U64 rawBytes = static_cast<U64>(header.NumSectors) * CD_SECTOR_SIZE;
+		ESX_CORE_LOG_INFO("CompressedDisc - {} written, {} sectors, {} -> {} bytes ({:.1f}%)", outPath.string(), header.NumSectors, rawBytes, offset, rawBytes > 0 ? offset * 100.0 / rawBytes : 0.0);
+
+		return ESX_TRUE;
+	}
+
+}
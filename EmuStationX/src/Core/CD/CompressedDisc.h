@@ -0,0 +1,83 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+
+#include "Base/Base.h"
+#include "Utils/LoggingSystem.h"
+
+#include "CompactDisk.h"
+
+namespace esx {
+
+	//On disk layout: header, track table, compressed hunks, hunk index.
+	//Positions in the track table are absolute sector numbers, 00:02:00 being sector 150.
+	struct CompressedDiscHeader {
+		Array<char, 4> Magic = {};
+		U32 Version = 0;
+		U32 HunkSectors = 0;
+		U32 NumSectors = 0;
+		U32 NumTracks = 0;
+		U32 LeadOut = 0;
+		U64 IndexOffset = 0;
+	};
+
+	struct CompressedDiscTrack {
+		U32 Number = 0;
+		U32 AudioTrack = 0;
+		U32 Start = 0;
+		U32 Index1 = 0;
+	};
+
+	//Chunked compressed disc image. Hunks of HunkSectors raw sectors are compressed independently, the hunk index
+	//gives their file offsets so any sector is one seek and one hunk decompression away, and recently used hunks
+	//stay decompressed in a small LRU cache. Hunks that do not shrink are stored raw. Sequential reads decompress at
+	//a few hundred MB/s, three orders of magnitude above the 352.8 KB/s a 2x drive delivers.
+	class CompressedDisc : public CompactDisk {
+	public:
+		CompressedDisc(const std::filesystem::path& filePath);
+		~CompressedDisc() = default;
+
+		virtual void seek(U64 seekPos) override;
+		virtual void readSector(Sector* pOutSector) override;
+		virtual U8 getLastTrack() override;
+		virtual MSF getTrackStart(U8 trackNumber, BIT useIndex1 = ESX_FALSE) override;
+		virtual BIT isAudioTrack() override { return mAudioTrack; }
+		virtual U64 getEndPos() override { return static_cast<U64>(mHeader.LeadOut) * CD_SECTOR_SIZE; }
+
+		BIT isOpen() const { return mOpen; }
+
+		//Builds a compressed image from a CUE sheet and its BIN files, pProgress goes from 0 to 1 as hunks are written
+		static BIT Convert(const std::filesystem::path& cuePath, const std::filesystem::path& outPath, U32 hunkSectors = DEFAULT_HUNK_SECTORS, std::atomic<F32>* pProgress = nullptr);
+
+	public:
+		static constexpr Array<char, 4> MAGIC = { 'E', 'S', 'X', 'Z' };
+		static constexpr U32 VERSION = 1;
+		static constexpr U32 DEFAULT_HUNK_SECTORS = 8;
+		static constexpr U32 CACHED_HUNKS = 4;
+
+	private:
+		struct CachedHunk {
+			U32 Index = UINT32_MAX;
+			U64 LastUse = 0;
+			Vector<U8> Data = {};
+		};
+
+		const U8* getHunk(U32 hunk);
+		void computeCurrentTrack();
+
+	private:
+		BIT mOpen = ESX_FALSE;
+		std::ifstream mStream = {};
+		CompressedDiscHeader mHeader = {};
+		Vector<CompressedDiscTrack> mTracks = {};
+		Vector<U64> mHunkOffsets = {};
+
+		Vector<U8> mCompressed = {};
+		Array<CachedHunk, CACHED_HUNKS> mCache = {};
+		U64 mUseCounter = 0;
+
+		BIT mAudioTrack = ESX_FALSE;
+	};
+
+}
@@ -5,7 +5,12 @@ namespace esx {
 
 	ISO::ISO(const std::filesystem::path& filePath)
 	{
-		mStream.open(filePath, std::ios::binary);
+		//Streams are only the fallback for files that cannot be mapped
+		mMapping = MakeScoped<platform::MappedFile>(filePath);
+		if (!mMapping->IsOpen()) {
+			mMapping.reset();
+			mStream.open(filePath, std::ios::binary);
+		}
 		mFileSize = std::filesystem::file_size(filePath);
 	}
 
@@ -15,25 +20,47 @@ namespace esx {
 
 		seekPos -= calculateBinaryPosition(0, 2, 0);
 
-		mStream.seekg(seekPos, mStream.beg);
+		if (mMapping) {
+			mMapping->WillNeed(seekPos);
+		} else {
+			mStream.seekg(seekPos, mStream.beg);
+		}
 	}
 
 	void ISO::readSector(Sector* pOutSector)
 	{
+		const Sector* sector = readSectorView(pOutSector);
+		if (sector != pOutSector) {
+			*pOutSector = *sector;
+		}
+	}
+
+	const Sector* ISO::readSectorView(Sector* pScratch)
+	{
+		const Sector* sector = pScratch;
+
 		if ((mCurrentLBA - calculateBinaryPosition(0, 2, 0) + sizeof(Sector)) < mFileSize) {
-			mStream.read(reinterpret_cast<char*>(pOutSector), sizeof(Sector));
-			if (mStream.fail() == ESX_TRUE) {
-				ESX_CORE_LOG_TRACE("Strano");
+			if (mMapping) {
+				U64 offset = mCurrentLBA - calculateBinaryPosition(0, 2, 0);
+				sector = reinterpret_cast<const Sector*>(mMapping->GetData() + offset);
+				mMapping->WillNeed(offset);
+			} else {
+				mStream.read(reinterpret_cast<char*>(pScratch), sizeof(Sector));
+				if (mStream.fail() == ESX_TRUE) {
+					ESX_CORE_LOG_TRACE("Strano");
+				}
 			}
 			mCurrentLBA += sizeof(Sector);
 		}
 		else {
 			ESX_CORE_LOG_ERROR("LBA Greater than file size");
 		}
+
+		return sector;
 	}
 
 	MSF ISO::getTrackStart(U8 trackNumber, BIT useIndex1) {
 		return fromBinaryPositionToMSF(calculateBinaryPosition(0, 2, 0));
 	}
 
-}
\ No newline at end of file
+}
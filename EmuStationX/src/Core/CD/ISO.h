@@ -7,6 +7,8 @@
 
 #include "CompactDisk.h"
 
+#include "Platform/Win32/MappedFile.h"
+
 namespace esx {
 
 	class ISO : public CompactDisk {
@@ -16,12 +18,16 @@ namespace esx {
 
 		virtual void seek(U64 seekPos) override;
 		virtual void readSector(Sector* pOutSector) override;
+		virtual const Sector* readSectorView(Sector* pScratch) override;
 		virtual U8 getLastTrack() override { return 1; }
 		virtual MSF getTrackStart(U8 trackNumber, BIT useIndex1 = ESX_FALSE) override;
+		virtual BIT providesSectorViews() override { return mMapping != nullptr; }
+		virtual U64 getEndPos() override { return calculateBinaryPosition(0, 2, 0) + mFileSize - sizeof(Sector); }
 
 	private:
 		StringView mFilePath;
 		FileInputStream mStream = {};
+		ScopedPtr<platform::MappedFile> mMapping = {};
 		U64 mFileSize = 0;
 	};
 
@@ -0,0 +1,149 @@
+#include "PrefetchDisk.h"
+
+namespace esx {
+
+	PrefetchDisk::PrefetchDisk(const SharedPtr<CompactDisk>& disk, U32 cacheSectors, U32 readAheadSectors)
+		: mDisk(disk), mReadAheadSectors(readAheadSectors)
+	{
+		mCache.resize(std::max(cacheSectors, readAheadSectors + 1));
+
+		mCurrentLBA = mDisk->getCurrentPos();
+		mTrackNumber = mDisk->getTrackNumber();
+		mWindowStart = mCurrentLBA;
+
+		mWorker = std::thread(&PrefetchDisk::prefetchLoop, this);
+	}
+
+	PrefetchDisk::~PrefetchDisk()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mCacheMutex);
+			mQuit = ESX_TRUE;
+		}
+		mWakeUp.notify_one();
+		mWorker.join();
+	}
+
+	void PrefetchDisk::seek(U64 seekPos)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mDiskMutex);
+			mDisk->seek(seekPos);
+			mCurrentLBA = mDisk->getCurrentPos();
+			mTrackNumber = mDisk->getTrackNumber();
+			mAudioTrack = mDisk->isAudioTrack();
+			mSubChannelQ = mDisk->getCurrentSubChannelQ();
+		}
+
+		//Moving the window is what cancels the prefetches still queued for the old position
+		{
+			std::lock_guard<std::mutex> lock(mCacheMutex);
+			mWindowStart = mCurrentLBA;
+		}
+		mWakeUp.notify_one();
+	}
+
+	void PrefetchDisk::readSector(Sector* pOutSector)
+	{
+		U64 position = mCurrentLBA;
+		CachedSector sector = {};
+
+		{
+			std::lock_guard<std::mutex> lock(mCacheMutex);
+			CachedSector& entry = getEntry(position);
+			if (entry.Valid && entry.Position == position) {
+				sector = entry;
+			}
+			mWindowStart = position + CD_SECTOR_SIZE;
+		}
+		mWakeUp.notify_one();
+
+		if (sector.Valid) {
+			mHits++;
+		} else {
+			mMisses++;
+			readFromDisk(position, sector);
+		}
+
+		*pOutSector = sector.Data;
+		mCurrentLBA = sector.NextPosition;
+		mTrackNumber = sector.TrackNumber;
+		mAudioTrack = sector.AudioTrack;
+		mSubChannelQ = sector.SubChannelQ;
+	}
+
+	U8 PrefetchDisk::getLastTrack()
+	{
+		std::lock_guard<std::mutex> lock(mDiskMutex);
+		return mDisk->getLastTrack();
+	}
+
+	MSF PrefetchDisk::getTrackStart(U8 trackNumber, BIT useIndex1)
+	{
+		std::lock_guard<std::mutex> lock(mDiskMutex);
+		return mDisk->getTrackStart(trackNumber, useIndex1);
+	}
+
+	void PrefetchDisk::prefetchLoop()
+	{
+		U64 endPos = 0;
+		{
+			std::lock_guard<std::mutex> lock(mDiskMutex);
+			endPos = mDisk->getEndPos();
+		}
+
+		while (ESX_TRUE) {
+			U64 position = 0;
+
+			{
+				std::unique_lock<std::mutex> lock(mCacheMutex);
+
+				//Closest sector of the window that is not cached yet
+				auto nextMissing = [&]() {
+					for (U32 i = 0; i < mReadAheadSectors; i++) {
+						U64 candidate = mWindowStart + static_cast<U64>(i) * CD_SECTOR_SIZE;
+						if (candidate >= endPos) break;
+
+						const CachedSector& entry = getEntry(candidate);
+						if (!entry.Valid || entry.Position != candidate) {
+							position = candidate;
+							return ESX_TRUE;
+						}
+					}
+					return ESX_FALSE;
+				};
+
+				mWakeUp.wait(lock, [&]() { return mQuit || nextMissing(); });
+				if (mQuit) return;
+			}
+
+			//A single sector read cannot be aborted, a seek in the meantime just makes it useless
+			CachedSector sector = {};
+			readFromDisk(position, sector);
+
+			{
+				std::lock_guard<std::mutex> lock(mCacheMutex);
+				if (position >= mWindowStart && position < mWindowStart + static_cast<U64>(mReadAheadSectors) * CD_SECTOR_SIZE) {
+					getEntry(position) = sector;
+				}
+			}
+		}
+	}
+
+	void PrefetchDisk::readFromDisk(U64 position, CachedSector& entry)
+	{
+		std::lock_guard<std::mutex> lock(mDiskMutex);
+
+		//The wrapped disk is shared with the prefetcher, so it is never assumed to still be where we left it
+		mDisk->seek(position);
+		mDisk->readSector(&entry.Data);
+
+		entry.Position = position;
+		entry.NextPosition = mDisk->getCurrentPos();
+		entry.TrackNumber = mDisk->getTrackNumber();
+		entry.AudioTrack = mDisk->isAudioTrack();
+		entry.SubChannelQ = mDisk->getCurrentSubChannelQ();
+		entry.Valid = ESX_TRUE;
+	}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+
+#include "Base/Base.h"
+#include "Utils/LoggingSystem.h"
+
+#include "CompactDisk.h"
+
+namespace esx {
+
+	//A sector as the wrapped disk returned it, with the disk state it was left in after reading it
+	struct CachedSector {
+		U64 Position = 0;
+		U64 NextPosition = 0;
+		BIT Valid = ESX_FALSE;
+		U8 TrackNumber = 0;
+		BIT AudioTrack = ESX_FALSE;
+		Optional<SubchannelQ> SubChannelQ = {};
+		Sector Data = {};
+	};
+
+	//Read-ahead layer over another disk. An I/O thread keeps the sectors following the current position cached,
+	//a seek moves the window and drops whatever was still queued for the old one.
+	//Every access to the wrapped disk goes through this class once it is wrapped.
+	class PrefetchDisk : public CompactDisk {
+	public:
+		PrefetchDisk(const SharedPtr<CompactDisk>& disk, U32 cacheSectors = DEFAULT_CACHE_SECTORS, U32 readAheadSectors = DEFAULT_READ_AHEAD_SECTORS);
+		~PrefetchDisk();
+
+		virtual void seek(U64 seekPos) override;
+		virtual void readSector(Sector* pOutSector) override;
+		virtual U8 getLastTrack() override;
+		virtual MSF getTrackStart(U8 trackNumber, BIT useIndex1 = ESX_FALSE) override;
+		virtual Optional<SubchannelQ> getCurrentSubChannelQ() override { return mSubChannelQ; }
+		virtual BIT isAudioTrack() override { return mAudioTrack; }
+
+		U64 getHits() const { return mHits; }
+		U64 getMisses() const { return mMisses; }
+
+	public:
+		static constexpr U32 DEFAULT_CACHE_SECTORS = 1024;
+		static constexpr U32 DEFAULT_READ_AHEAD_SECTORS = 64;
+
+	private:
+		void prefetchLoop();
+		void readFromDisk(U64 position, CachedSector& entry);
+		CachedSector& getEntry(U64 position) { return mCache[(position / CD_SECTOR_SIZE) % mCache.size()]; }
+
+	private:
+		SharedPtr<CompactDisk> mDisk;
+		U32 mReadAheadSectors;
+
+		//Owned by the emulation thread
+		BIT mAudioTrack = ESX_FALSE;
+		Optional<SubchannelQ> mSubChannelQ = {};
+		U64 mHits = 0;
+		U64 mMisses = 0;
+
+		//mDiskMutex serializes the wrapped disk, mCacheMutex guards the cache and the prefetch window
+		std::mutex mDiskMutex;
+		std::mutex mCacheMutex;
+		std::condition_variable mWakeUp;
+		Vector<CachedSector> mCache = {};
+		U64 mWindowStart = 0;
+		BIT mQuit = ESX_FALSE;
+
+		std::thread mWorker;
+	};
+
+}
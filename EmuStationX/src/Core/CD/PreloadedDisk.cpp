@@ -0,0 +1,140 @@
+#include "PreloadedDisk.h"
+
+#include <chrono>
+
+namespace esx {
+
+	PreloadedDisk::PreloadedDisk(const SharedPtr<CompactDisk>& disk, BIT background)
+		: mDisk(disk)
+	{
+		mCurrentLBA = mDisk->getCurrentPos();
+		mTrackNumber = mDisk->getTrackNumber();
+
+		mFirstPosition = calculateBinaryPosition(0, 2, 0);
+		U64 endPos = mDisk->getEndPos();
+		if (endPos == UINT64_MAX || endPos <= mFirstPosition) {
+			ESX_CORE_LOG_WARNING("PreloadedDisk - Disc size unknown, reading it from its source");
+			return;
+		}
+
+		U64 numSectors = (endPos - mFirstPosition) / CD_SECTOR_SIZE;
+		mSectors.resize(numSectors);
+		mStates.resize(numSectors + 1);
+
+		if (background) {
+			mLoader = std::thread(&PreloadedDisk::load, this);
+		} else {
+			load();
+		}
+	}
+
+	PreloadedDisk::~PreloadedDisk()
+	{
+		mQuit.store(ESX_TRUE, std::memory_order_release);
+		if (mLoader.joinable()) {
+			mLoader.join();
+		}
+	}
+
+	void PreloadedDisk::seek(U64 seekPos)
+	{
+		U64 index = 0;
+		if (findLoaded(seekPos, index)) {
+			mCurrentLBA = seekPos;
+			mSubChannelQ = {};
+			applyState(mStates[index]);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mDiskMutex);
+		mDisk->seek(seekPos);
+		mCurrentLBA = mDisk->getCurrentPos();
+		mSubChannelQ = mDisk->getCurrentSubChannelQ();
+		applyState(captureState());
+	}
+
+	void PreloadedDisk::readSector(Sector* pOutSector)
+	{
+		const Sector* sector = readSectorView(pOutSector);
+		if (sector != pOutSector) {
+			*pOutSector = *sector;
+		}
+	}
+
+	const Sector* PreloadedDisk::readSectorView(Sector* pScratch)
+	{
+		U64 index = 0;
+		if (findLoaded(mCurrentLBA, index)) {
+			mCurrentLBA += sizeof(Sector);
+			mSubChannelQ = {};
+			applyState(mStates[index + 1]);
+			return &mSectors[index];
+		}
+
+		//The loader moves the wrapped disk around, so it is never assumed to still be where we left it
+		std::lock_guard<std::mutex> lock(mDiskMutex);
+		mDisk->seek(mCurrentLBA);
+		const Sector* sector = mDisk->readSectorView(pScratch);
+		mCurrentLBA = mDisk->getCurrentPos();
+		mSubChannelQ = mDisk->getCurrentSubChannelQ();
+		applyState(captureState());
+		return sector;
+	}
+
+	U8 PreloadedDisk::getLastTrack()
+	{
+		std::lock_guard<std::mutex> lock(mDiskMutex);
+		return mDisk->getLastTrack();
+	}
+
+	MSF PreloadedDisk::getTrackStart(U8 trackNumber, BIT useIndex1)
+	{
+		std::lock_guard<std::mutex> lock(mDiskMutex);
+		return mDisk->getTrackStart(trackNumber, useIndex1);
+	}
+
+	void PreloadedDisk::load()
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		U64 loaded = 0;
+		while (loaded < mSectors.size() && !mQuit.load(std::memory_order_acquire)) {
+			U64 count = std::min<U64>(CHUNK_SECTORS, mSectors.size() - loaded);
+
+			//Chunks keep the lock short so on demand reads are not stuck behind the whole load
+			{
+				std::lock_guard<std::mutex> lock(mDiskMutex);
+				mDisk->seek(mFirstPosition + loaded * CD_SECTOR_SIZE);
+				if (loaded == 0) {
+					mStates[0] = captureState();
+				}
+
+				for (U64 i = loaded; i < loaded + count; i++) {
+					mDisk->readSector(&mSectors[i]);
+					mStates[i + 1] = captureState();
+				}
+			}
+
+			loaded += count;
+			mLoadedSectors.store(loaded, std::memory_order_release);
+		}
+
+		F64 seconds = std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count();
+		ESX_CORE_LOG_INFO("PreloadedDisk - {} of {} sectors loaded in {:.2f}s", loaded, mSectors.size(), seconds);
+	}
+
+	BIT PreloadedDisk::findLoaded(U64 position, U64& index) const
+	{
+		if (position < mFirstPosition || ((position - mFirstPosition) % CD_SECTOR_SIZE) != 0) return ESX_FALSE;
+
+		index = (position - mFirstPosition) / CD_SECTOR_SIZE;
+		return index < mLoadedSectors.load(std::memory_order_acquire);
+	}
+
+	void PreloadedDisk::applyState(const SectorState& state)
+	{
+		mTrackNumber = state.TrackNumber;
+		mAudioTrack = state.AudioTrack;
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Base/Base.h"
+#include "Utils/LoggingSystem.h"
+
+#include "CompactDisk.h"
+
+namespace esx {
+
+	enum class DiscPreload {
+		Off,
+		Background,
+		Synchronous
+	};
+
+	//Copy of a whole disc image in RAM. The wrapped disk is read front to back, either before the constructor
+	//returns or on a loader thread, and sectors that are not loaded yet are still read from it on demand.
+	//Only disks with a known end can be loaded, anything else is passed through untouched.
+	class PreloadedDisk : public CompactDisk {
+	public:
+		PreloadedDisk(const SharedPtr<CompactDisk>& disk, BIT background);
+		~PreloadedDisk();
+
+		virtual void seek(U64 seekPos) override;
+		virtual void readSector(Sector* pOutSector) override;
+		virtual const Sector* readSectorView(Sector* pScratch) override;
+		virtual U8 getLastTrack() override;
+		virtual MSF getTrackStart(U8 trackNumber, BIT useIndex1 = ESX_FALSE) override;
+		virtual Optional<SubchannelQ> getCurrentSubChannelQ() override { return mSubChannelQ; }
+		virtual U64 getEndPos() override { return mDisk->getEndPos(); }
+		virtual BIT isAudioTrack() override { return mAudioTrack; }
+		virtual BIT providesSectorViews() override { return !mSectors.empty() || mDisk->providesSectorViews(); }
+
+		BIT isLoaded() const { return mLoadedSectors.load(std::memory_order_acquire) == mSectors.size(); }
+
+	public:
+		static constexpr U32 CHUNK_SECTORS = 64;
+
+	private:
+		//Disk state at a sector's position, what a seek there or a read ending there leaves behind
+		struct SectorState {
+			U8 TrackNumber = 0;
+			BIT AudioTrack = ESX_FALSE;
+		};
+
+		void load();
+		BIT findLoaded(U64 position, U64& index) const;
+		SectorState captureState() { return { mDisk->getTrackNumber(), mDisk->isAudioTrack() }; }
+		void applyState(const SectorState& state);
+
+	private:
+		SharedPtr<CompactDisk> mDisk;
+		std::mutex mDiskMutex;
+
+		U64 mFirstPosition = 0;
+		Vector<Sector> mSectors = {};
+		Vector<SectorState> mStates = {};
+		std::atomic<U64> mLoadedSectors = 0;
+		std::atomic<BIT> mQuit = ESX_FALSE;
+		std::thread mLoader = {};
+
+		BIT mAudioTrack = ESX_FALSE;
+		Optional<SubchannelQ> mSubChannelQ = {};
+	};
+
+}
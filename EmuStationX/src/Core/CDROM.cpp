@@ -2,6 +2,7 @@
 
 #include "InterruptControl.h"
 #include "R3000.h"
+#include "SPU.h"
 
 #include "Core/Scheduler.h"
 
@@ -12,6 +13,10 @@ namespace esx {
 	{
 		addRange(ESX_TEXT("Root"), 0x1F801800, BYTE(0x4), 0xFFFFFFFF);
 
+		for (U32 i = 0; i < mSectors.size(); i++) {
+			mSectorViews[i] = &mSectors[i];
+		}
+
 		Scheduler::AddSchedulerEventHandler(SchedulerEventType::CDROMCommand, [&](const SchedulerEvent& ev) {
 			size_t serial = ev.Read<size_t>();
 
@@ -31,6 +36,35 @@ namespace esx {
 	{
 	}
 
+	void CDROM::init()
+	{
+		mSPU = getBus("Root")->getDevice<SPU>("SPU");
+	}
+
+	void CDROM::syncAudio()
+	{
+		if (mSPU) {
+			mSPU->syncSamples();
+		}
+	}
+
+	void CDROM::insertCD(const SharedPtr<CompactDisk>& cd, DiscPreload preload)
+	{
+		//Views into the old disk die with it, keep what the buffered sectors hold
+		for (U32 i = 0; i < mSectors.size(); i++) {
+			if (mSectorViews[i] != &mSectors[i]) {
+				mSectors[i] = *mSectorViews[i];
+				mSectorViews[i] = &mSectors[i];
+			}
+		}
+
+		if (cd && preload != DiscPreload::Off) {
+			mCD = MakeShared<PreloadedDisk>(cd, preload == DiscPreload::Background);
+		} else {
+			mCD = cd;
+		}
+	}
+
 	void CDROM::clock(U64 clocks)
 	{
 	}
@@ -202,6 +236,7 @@ namespace esx {
 
 					ESX_CORE_LOG_INFO("{:08x}h - CDROM - Play {} {}", cpu->mCurrentInstruction.Address, track, response.Number);
 
+					syncAudio();
 					mAudioFrames.clear();
 					CDROM_REG0.ADPCMFifoEmpty = ESX_TRUE;
 
@@ -248,12 +283,11 @@ namespace esx {
 					mCurrentSector = mNextSector;
 					mNextSector = (mNextSector + 1) % mSectors.size();
 
-					Sector& currentSector = mSectors[mCurrentSector];
-
-					mCD->readSector(&currentSector);
+					mSectorViews[mCurrentSector] = mCD->readSectorView(&mSectors[mCurrentSector]);
+					const Sector& currentSector = *mSectorViews[mCurrentSector];
 
 					U32 peek = 0;
-					Span<AudioFrame> buffer(reinterpret_cast<AudioFrame*>(&currentSector), reinterpret_cast<AudioFrame*>(reinterpret_cast<U8*>(&currentSector) + sizeof(Sector)));
+					Span<const AudioFrame> buffer(reinterpret_cast<const AudioFrame*>(&currentSector), reinterpret_cast<const AudioFrame*>(reinterpret_cast<const U8*>(&currentSector) + sizeof(Sector)));
 
 					/*I32 numSamples = buffer.size();
 					I32 remainingSpace = (44100 * 2) - mAudioFrames.size();
@@ -264,7 +298,8 @@ namespace esx {
 						}
 					}*/
 
-					for (AudioFrame& frame : buffer) {
+					syncAudio();
+					for (const AudioFrame& frame : buffer) {
 						Output44100Hz(frame);
 
 						peek = std::max<U32>(mPlayPeekRight ? std::abs(frame.Right) : std::abs(frame.Left), peek);
@@ -352,10 +387,9 @@ namespace esx {
 					mCurrentSector = mNextSector;
 					mNextSector = (mNextSector + 1) % mSectors.size();
 
-					Sector& currentSector = mSectors[mCurrentSector];
-
+					mSectorViews[mCurrentSector] = mCD->readSectorView(&mSectors[mCurrentSector]);
+					const Sector& currentSector = *mSectorViews[mCurrentSector];
 
-					mCD->readSector(&currentSector);
 					mLastSubQ = mCD->getCurrentSubChannelQ().value_or(generateSubChannelQ());
 
 					U8 audioRealTimeMask = SubmodeFlagAudio | SubmodeFlagRealTime;
@@ -408,6 +442,7 @@ namespace esx {
 
 				response.NumberOfResponses = 2;
 				if (response.Number == 1) {
+					syncAudio();
 					mAudioFrames.clear();
 					CDROM_REG0.ADPCMFifoEmpty = ESX_TRUE;
 
@@ -449,12 +484,14 @@ namespace esx {
 
 			case CommandType::Mute: {
 				ESX_CORE_LOG_INFO("{:08x}h - CDROM - Mute", cpu->mCurrentInstruction.Address);
+				syncAudio();
 				mAudioStreamingMuteCDDA = mAudioStreamingMuteADPCM = ESX_TRUE;
 				break;
 			}
 
 			case CommandType::Demute: {
 				ESX_CORE_LOG_INFO("{:08x}h - CDROM - Demute", cpu->mCurrentInstruction.Address);
+				syncAudio();
 				mAudioStreamingMuteCDDA = mAudioStreamingMuteADPCM = ESX_FALSE;
 				break;
 			}
@@ -480,8 +517,8 @@ namespace esx {
 				ESX_CORE_LOG_INFO("{:08x}h - CDROM - GetlocL", cpu->mCurrentInstruction.Address);
 
 				response.Clear();
-				U8* begin = reinterpret_cast<U8*>(&(mSectors[mCurrentSector].Header[0]));
-				for (U8* it = begin; it < (begin + 8); it++) {
+				const U8* begin = reinterpret_cast<const U8*>(&(mSectorViews[mCurrentSector]->Header[0]));
+				for (const U8* it = begin; it < (begin + 8); it++) {
 					response.Push(*it);
 				}
 
@@ -700,6 +737,7 @@ namespace esx {
 			return;
 		}
 
+		syncAudio();
 		CDROM_REG0.ADPCMFifoEmpty = ESX_FALSE;
 
 		auto xaSector = reinterpret_cast<const XAADPCMSector*>(sector.UserData.data());
@@ -813,6 +851,7 @@ namespace esx {
 		reg.MuteADPCM = (value >> 0) & 0x1;
 		reg.ApplyChanges = (value >> 5) & 0x1;
 
+		syncAudio();
 		mAudioStreamingMuteADPCM = reg.MuteADPCM;
 
 		if (reg.ApplyChanges) {
@@ -856,11 +895,11 @@ namespace esx {
 
 		ESX_CORE_LOG_INFO("{:08x}h - CDROM - Request Register WantData => {}, BFWR => {}, WantCommandStartInterrupt => {}, CurrentSector => {:02x},{:02x},{:02x}",
 			cpu->mCurrentInstruction.Address, requestRegister.WantData, requestRegister.BFWR, requestRegister.WantCommandStartInterrupt,
-			mSectors[mOldSector].Header[0], mSectors[mOldSector].Header[1], mSectors[mOldSector].Header[2]);
+			mSectorViews[mOldSector]->Header[0], mSectorViews[mOldSector]->Header[1], mSectorViews[mOldSector]->Header[2]);
 
 		if (requestRegister.WantData) {
 			if (CDROM_REG0.DataFifoEmpty == ESX_TRUE) {
-				std::memcpy(mData.data(), &mSectors[mOldSector], mData.size());
+				std::memcpy(mData.data(), mSectorViews[mOldSector], mData.size());
 				mDataReadPointer = mLastWholeSector ? offsetof(Sector, Header) : offsetof(Sector, UserData);
 				mDataWritePointer = mLastWholeSector ? CD_SECTOR_SIZE : CD_SECTOR_DATA_SIZE;
 				mDataWritePointer += mDataReadPointer;
@@ -909,7 +948,7 @@ namespace esx {
 			if (mResponses.contains(serial)) {
 				Response& response = mResponses.at(serial);
 				if ((response.CommandType == CommandType::ReadN || response.CommandType == CommandType::ReadS) && response.Code == INT1) {
-					if ((mMode.XAFilter == ESX_TRUE && (mSectors[mCurrentSector].Subheader[0] != mXAFilterFile || (mSectors[mCurrentSector].Subheader[1] & 0x1F) != mXAFilterChannel))) {
+					if ((mMode.XAFilter == ESX_TRUE && (mSectorViews[mCurrentSector]->Subheader[0] != mXAFilterFile || (mSectorViews[mCurrentSector]->Subheader[1] & 0x1F) != mXAFilterChannel))) {
 						response.GenerateInterrupt = ESX_FALSE;
 					}
 				}
@@ -986,6 +1025,19 @@ namespace esx {
 		return value;
 	}
 
+	void CDROM::popData(U8* output, U32 size)
+	{
+		//Same as size popData() calls, an empty FIFO reads as zero
+		U32 available = std::min<U32>(size, mDataWritePointer - mDataReadPointer);
+		std::memcpy(output, &mData[mDataReadPointer], available);
+		std::memset(output + available, 0, size - available);
+		mDataReadPointer += available;
+
+		if (mDataReadPointer == mDataWritePointer) {
+			CDROM_REG0.DataFifoEmpty = ESX_TRUE;
+		}
+	}
+
 	void CDROM::reset()
 	{
 		CDROM_REG0 = {};
@@ -4,6 +4,7 @@
 #include "Base/Bus.h"
 
 #include "CD/CompactDisk.h"
+#include "CD/PreloadedDisk.h"
 
 namespace esx {
 
@@ -349,19 +350,25 @@ namespace esx {
 		BIT Empty() { return Size == ReadPointer; }
 	};
 
+	class SPU;
+
 	class CDROM : public BusDevice {
 	public:
 		CDROM();
 		~CDROM();
 
+		virtual void init() override;
+
 		virtual void clock(U64 clocks)override;
 
 		virtual void store(const StringView& busName, U32 address, U8 value) override;
 		virtual void load(const StringView& busName, U32 address, U8& output) override;
 
-		void insertCD(const SharedPtr<CompactDisk>& cd) { mCD = cd; }
+		void insertCD(const SharedPtr<CompactDisk>& cd, DiscPreload preload = DiscPreload::Off);
+		const SharedPtr<CompactDisk>& getCD() const { return mCD; }
 
 		U8 popData();
+		void popData(U8* output, U32 size);
 
 		virtual void reset() override;
 
@@ -369,6 +376,7 @@ namespace esx {
 		AudioFrame GetAudioFrame();
 
 	private:
+		void syncAudio();
 		void command(CommandType command, U32 responseNumber = 1);
 		void handleResponse(U64 serial);
 
@@ -432,6 +440,8 @@ namespace esx {
 
 		Array<U8, CD_SECTOR_SIZE> mData; U32 mDataReadPointer = 0; U32 mDataWritePointer = 0;
 		Array<Sector, 8> mSectors; U32 mOldSector = 0; U32 mCurrentSector = 0; U32 mNextSector = 0;
+		//Where each buffered sector actually lives, mSectors or storage owned by the disk
+		Array<const Sector*, 8> mSectorViews = {};
 
 		CDROMStatusRegister mStat = {};
 		CDROMModeRegister mMode = {};
@@ -455,6 +465,8 @@ namespace esx {
 
 
 		SubchannelQ mLastSubQ = {};
+		//Drained lazily by the SPU, which has to catch up before anything changes what it would have read
+		SharedPtr<SPU> mSPU;
 		Deque<AudioFrame> mAudioFrames = {};
 		XAADPCMDecoder mXAADPCMDecoder = {};
 
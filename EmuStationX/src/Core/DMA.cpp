@@ -391,16 +391,21 @@ namespace esx {
 		switch (channel.SyncMode) {
 			case SyncMode::LinkedList: {
 				startLinkedListTransfer(channel);
-				while (clockLinkedListTransfer(channel)) {
-					NumWords++;
-				}
+				NumWords = walkLinkedList(channel);
 				break;
 			}
 
 			default: {
 				startBlockTransfer(channel);
-				while (clockBlockTransfer(channel)) {
-					NumWords++;
+
+				U32 blockWords = channel.TransferStatus.BlockRemainingSize;
+				if (bulkBlockTransfer(channel)) {
+					//Same count the word by word loop ends up with
+					NumWords = blockWords - 1;
+				} else {
+					while (clockBlockTransfer(channel)) {
+						NumWords++;
+					}
 				}
 				break;
 			}
@@ -477,6 +482,7 @@ namespace esx {
 					}
 
 					case Port::SPU: {
+						mSPU->syncSamples();
 						valueToWrite = mSPU->readFromRAM<U32>();
 						break;
 					}
@@ -499,6 +505,7 @@ namespace esx {
 						break;
 					}
 					case Port::SPU: {
+						mSPU->syncSamples();
 						mSPU->writeToRAM<U32>(value);
 						break;
 					}
@@ -532,6 +539,106 @@ namespace esx {
 	}
 
 
+	BIT DMA::bulkBlockTransfer(Channel& channel)
+	{
+		U32 numWords = channel.TransferStatus.BlockRemainingSize;
+		if (numWords == 0 || numWords > (0x200000 / 4)) {
+			return ESX_FALSE;
+		}
+
+		//Only runs that do not wrap around the 2MB of RAM can be moved through the fast pointer
+		U32 currentAddress = channel.TransferStatus.BlockCurrentAddress & 0x1FFFFC;
+		U32 size = numWords * 4;
+		U32 lowestAddress = 0;
+		if (channel.Step == Step::Forward) {
+			if (currentAddress + size > 0x200000) return ESX_FALSE;
+			lowestAddress = currentAddress;
+		} else {
+			if (currentAddress < (size - 4)) return ESX_FALSE;
+			lowestAddress = currentAddress - (size - 4);
+		}
+
+		U8* memory = mRAM->getFastPointer(lowestAddress);
+
+		switch (channel.Direction) {
+			case Direction::ToMainRAM: {
+				switch (channel.Port) {
+					case Port::OTC: {
+						if (channel.Step != Step::Backward) return ESX_FALSE;
+
+						//Each entry links to the one below it, the lowest one terminates the table
+						U32* table = reinterpret_cast<U32*>(memory);
+						table[0] = 0xFFFFFF;
+						for (U32 i = 1; i < numWords; i++) {
+							table[i] = (lowestAddress + (i - 1) * 4) & 0x1FFFFF;
+						}
+						break;
+					}
+
+					case Port::CDROM: {
+						if (channel.Step != Step::Forward) return ESX_FALSE;
+						mCDROM->popData(memory, size);
+						break;
+					}
+
+					case Port::SPU: {
+						if (channel.Step != Step::Forward) return ESX_FALSE;
+						mSPU->readFromRAM(memory, size);
+						break;
+					}
+
+					case Port::MDECout: {
+						if (channel.Step != Step::Forward) return ESX_FALSE;
+						mMDEC->channelOut(reinterpret_cast<U32*>(memory), numWords);
+						break;
+					}
+
+					default: {
+						return ESX_FALSE;
+					}
+				}
+				break;
+			}
+
+			case Direction::FromMainRAM: {
+				switch (channel.Port) {
+					case Port::MDECin: {
+						if (channel.Step != Step::Forward) return ESX_FALSE;
+						mMDEC->channelIn(reinterpret_cast<const U32*>(memory), numWords);
+						break;
+					}
+
+					case Port::SPU: {
+						if (channel.Step != Step::Forward) return ESX_FALSE;
+						mSPU->writeToRAM(memory, size);
+						break;
+					}
+
+					case Port::GPU: {
+						if (channel.Step != Step::Forward) return ESX_FALSE;
+						mGPU->gp0Batch(reinterpret_cast<const U32*>(memory), numWords);
+						break;
+					}
+
+					default: {
+						return ESX_FALSE;
+					}
+				}
+				break;
+			}
+		}
+
+		I32 increment = (channel.Step == Step::Forward) ? 4 : -4;
+		channel.TransferStatus.BlockCurrentAddress += increment * (I32)numWords;
+		channel.TransferStatus.BlockRemainingSize = 0;
+
+		if (channel.SyncMode == SyncMode::Slice) {
+			channel.BaseAddress = channel.TransferStatus.BlockCurrentAddress;
+		}
+
+		return ESX_TRUE;
+	}
+
 	void DMA::startLinkedListTransfer(Channel& channel)
 	{
 		ESX_CORE_ASSERT(channel.Port == Port::GPU, "DMA Linked List Port {} not supported yet", (U8)channel.Port);
@@ -546,36 +653,63 @@ namespace esx {
 		//ESX_CORE_LOG_TRACE("DMA - Starting Linked List Transfer starting node {:08x}h on port {}", channel.TransferStatus.LinkedListCurrentNodeAddress, (U8)channel.Port);
 	}
 
-	BIT DMA::clockLinkedListTransfer(Channel& channel)
+	U32 DMA::walkLinkedList(Channel& channel)
 	{
+		//Nodes are read straight from RAM and each packet reaches the GPU as a single span
+		const U8* memory = mRAM->getFastPointer(0);
 		TransferStatus& transferStatus = channel.TransferStatus;
 
+		U32 numWords = 0;
+		U32 numNodes = 0;
 
-		if (transferStatus.LinkedListRemainingSize == 0) {
-			transferStatus.LinkedListCurrentNodeHeader = mBus->load<U32>(transferStatus.LinkedListCurrentNodeAddress);
-			transferStatus.LinkedListNextNodeAddress = transferStatus.LinkedListCurrentNodeHeader & 0x1FFFFC;
-			transferStatus.LinkedListRemainingSize = transferStatus.LinkedListCurrentNodeHeader >> 24;
-			transferStatus.LinkedListPacketAddress = (transferStatus.LinkedListCurrentNodeAddress + 4) & 0x1FFFFC;
-		}
+		//Brent's cycle detection, a corrupt list must not hang the host
+		U32 cycleMarker = transferStatus.LinkedListCurrentNodeAddress;
+		U32 cyclePower = 1;
+		U32 cycleLength = 0;
 
-		if (transferStatus.LinkedListRemainingSize > 0) {
-			U32 packet = mBus->load<U32>(transferStatus.LinkedListPacketAddress);
-			mGPU->gp0(packet);
+		while (ESX_TRUE) {
+			U32 nodeAddress = transferStatus.LinkedListCurrentNodeAddress;
+			U32 header = *reinterpret_cast<const U32*>(memory + nodeAddress);
+			U32 size = header >> 24;
 
-			transferStatus.LinkedListRemainingSize--;
-			transferStatus.LinkedListPacketAddress = (transferStatus.LinkedListPacketAddress + 4) & 0x1FFFFC;
-		}
+			transferStatus.LinkedListCurrentNodeHeader = header;
+			transferStatus.LinkedListNextNodeAddress = header & 0x1FFFFC;
+			transferStatus.LinkedListPacketAddress = (nodeAddress + 4) & 0x1FFFFC;
 
-		if (transferStatus.LinkedListRemainingSize == 0) {
-			if ((transferStatus.LinkedListCurrentNodeHeader & 0x800000) != 0) {
-				return ESX_FALSE;
+			U32 packetAddress = transferStatus.LinkedListPacketAddress;
+			if (packetAddress + size * 4 <= 0x200000) {
+				mGPU->gp0Batch(reinterpret_cast<const U32*>(memory + packetAddress), size);
 			} else {
-				transferStatus.LinkedListCurrentNodeAddress = transferStatus.LinkedListNextNodeAddress;
-				channel.BaseAddress = transferStatus.LinkedListCurrentNodeAddress;
+				for (U32 i = 0; i < size; i++) {
+					mGPU->gp0(*reinterpret_cast<const U32*>(memory + ((packetAddress + i * 4) & 0x1FFFFC)));
+				}
+			}
+
+			//Matches the word by word walker, empty nodes still cost a step
+			numWords += std::max<U32>(size, 1);
+
+			if ((header & 0x800000) != 0) {
+				break;
+			}
+
+			transferStatus.LinkedListCurrentNodeAddress = transferStatus.LinkedListNextNodeAddress;
+			channel.BaseAddress = transferStatus.LinkedListCurrentNodeAddress;
+
+			if (transferStatus.LinkedListCurrentNodeAddress == cycleMarker || ++numNodes >= MAX_LINKED_LIST_NODES) {
+				ESX_CORE_LOG_ERROR("DMA - Linked list loops at {:08x}h, transfer aborted", transferStatus.LinkedListCurrentNodeAddress);
+				break;
+			}
+
+			if (++cycleLength == cyclePower) {
+				cycleMarker = transferStatus.LinkedListCurrentNodeAddress;
+				cyclePower <<= 1;
+				cycleLength = 0;
 			}
 		}
 
-		return ESX_TRUE;
+		transferStatus.LinkedListRemainingSize = 0;
+
+		return numWords - 1;
 	}
 
 
@@ -106,6 +106,9 @@ namespace esx {
 	class MDEC;
 	class R3000;
 
+	//Upper bound on visited nodes, 2MB of RAM cannot hold more distinct ones
+	constexpr U32 MAX_LINKED_LIST_NODES = 0x200000 / 4;
+
 	class DMA : public BusDevice {
 	public:
 		DMA();
@@ -146,9 +149,10 @@ namespace esx {
 
 		void startBlockTransfer(Channel& channel);
 		BIT clockBlockTransfer(Channel& channel);
+		BIT bulkBlockTransfer(Channel& channel);
 
 		void startLinkedListTransfer(Channel& channel);
-		BIT clockLinkedListTransfer(Channel& channel);
+		U32 walkLinkedList(Channel& channel);
 
 	private:
 		ControlRegister mControlRegister;
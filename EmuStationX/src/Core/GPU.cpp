@@ -57,6 +57,10 @@ namespace esx {
 	void GPU::gp0(U32 instruction)
 	{
 		if (mCurrentCommand.Complete == ESX_TRUE) {
+			if (mVRAMReadPending) {
+				resolveVRAMRead();
+			}
+
 			U8 opcode = (instruction >> 29) & 0x7;
 			switch (opcode) {
 				case 0b000:
@@ -129,6 +133,7 @@ namespace esx {
 				mPixelsToTransfer.emplace_back(IRenderer::fromU16(pixel1));
 
 				if (mCurrentCommand.IsComplete(instruction)) {
+					submitPrimitives();
 					mRenderer->VRAMWrite(mMemoryTransferDestinationCoordsX, mMemoryTransferDestinationCoordsY, mMemoryTransferWidth, mMemoryTransferHeight, mPixelsToTransfer);
 
 					mMemoryTransferX = mMemoryTransferY = 0;
@@ -146,6 +151,26 @@ namespace esx {
 		}
 	}
 
+	void GPU::gp0Batch(const U32* instructions, size_t count)
+	{
+		while (count > 0) {
+			//Image data is appended in one go, the last word still goes through gp0 to complete the transfer
+			if (mMode == GP0Mode::CPUtoVRAM && mCurrentCommand.RemainingParameters > 1) {
+				size_t numWords = std::min<size_t>(count, mCurrentCommand.RemainingParameters - 1);
+				const VRAMColor* pixels = reinterpret_cast<const VRAMColor*>(instructions);
+				mPixelsToTransfer.insert(mPixelsToTransfer.end(), pixels, pixels + numWords * 2);
+
+				mCurrentCommand.RemainingParameters -= numWords;
+				instructions += numWords;
+				count -= numWords;
+				continue;
+			}
+
+			gp0(*instructions++);
+			count--;
+		}
+	}
+
 	void GPU::gp1(U32 instruction)
 	{
 		U8 command = (instruction >> 24) & 0xFF;
@@ -223,6 +248,10 @@ namespace esx {
 	U32 GPU::gpuRead()
 	{
 		if (mGPUStat.ReadySendVRAMToCPU) {
+			if (mVRAMReadPending) {
+				resolveVRAMRead();
+			}
+
 			U32 numHalfWords = mMemoryTransferWidth * mMemoryTransferHeight;
 			BIT isOdd = numHalfWords % 2;
 
@@ -268,11 +297,84 @@ namespace esx {
 	{
 		mTimer->endVblank();
 
+		submitPrimitives();
 		mRenderer->FlushVRAMWrites();
 		mRenderer->Flush();
 		mRenderer->Begin();
 
-		mFrameAvailable = ESX_TRUE;
+		if (!mSkipFrame) {
+			//Whatever skipped frames left unrasterized on screen has to be there before presenting
+			mRenderer->ResolveArea(mVRAMStartX, mVRAMStartY, getDisplayWidth(), getDisplayHeight());
+			mFrameAvailable = ESX_TRUE;
+		}
+		mFrameComplete = ESX_TRUE;
+
+		mSkipFrame = shouldSkipFrame();
+		mRenderer->SetSkipRendering(mSkipFrame);
+	}
+
+	void GPU::submitPrimitives()
+	{
+		//Primitives are queued until something else has to reach the renderer in order
+		if (!mPrimitiveBatch.empty()) {
+			mRenderer->Submit(mPrimitiveBatch);
+			mPrimitiveBatch.clear();
+		}
+	}
+
+	BIT GPU::shouldSkipFrame()
+	{
+		auto now = std::chrono::steady_clock::now();
+		F64 elapsed = std::chrono::duration<F64>(now - mLastFrameTime).count();
+		mLastFrameTime = now;
+
+		BIT skip = ESX_FALSE;
+		if (mTurboFrames == 0) {
+			//Uncapped turbo draws a frame once per host refresh
+			mTurboElapsed += elapsed;
+			skip = mTurboElapsed < (1.0 / 60.0);
+			if (!skip) mTurboElapsed = 0.0;
+		} else if (mTurboFrames > 1) {
+			skip = mSkippedFrames < (mTurboFrames - 1);
+		} else {
+			switch (mFrameSkipMode) {
+				case FrameSkipMode::Fixed: {
+					skip = mSkippedFrames < mFrameSkip;
+					break;
+				}
+
+				case FrameSkipMode::Auto: {
+					//Skip while the host is behind by more than a frame, never more than mFrameSkip in a row
+					F64 budget = (mGPUStat.VideoMode == VideoMode::PAL) ? (1.0 / 50.0) : (1.0 / 60.0);
+					mFrameLag = std::clamp(mFrameLag + elapsed - budget, 0.0, budget * 4.0);
+					skip = mFrameLag > budget && mSkippedFrames < mFrameSkip;
+					break;
+				}
+
+				case FrameSkipMode::Off:
+					break;
+			}
+		}
+
+		mSkippedFrames = skip ? (mSkippedFrames + 1) : 0;
+		return skip;
+	}
+
+	U16 GPU::getDisplayWidth() const
+	{
+		switch (mGPUStat.HorizontalResolution) {
+			case HorizontalResolution::H256: return 256;
+			case HorizontalResolution::H320: return 320;
+			case HorizontalResolution::H368: return 368;
+			case HorizontalResolution::H512: return 512;
+			case HorizontalResolution::H640: return 640;
+		}
+		return 0;
+	}
+
+	U16 GPU::getDisplayHeight() const
+	{
+		return (mGPUStat.VerticalResolution == VerticalResolution::V480) ? 480 : 240;
 	}
 
 	void GPU::newScanline(U64 clocks)
@@ -340,10 +442,15 @@ namespace esx {
 		mNumWordsToTransfer = 0x00000000;
 		mCurrentWordNumber = 0x00000000;
 		mPixelsToTransfer = {};
+		mVRAMReadPending = ESX_FALSE;
 
 		mFrames = 0;
 		mCurrentScanLine = 0;
 		mFrameAvailable = ESX_FALSE;
+		mFrameComplete = ESX_FALSE;
+		mSkipFrame = ESX_FALSE;
+		mSkippedFrames = 0;
+		mFrameLag = 0.0;
 
 		mScanlinesPerFrame = 0;
 		mClocksPerScanline = 0;
@@ -395,6 +502,7 @@ namespace esx {
 		Scheduler::ScheduleEvent(startVBlank);
 		Scheduler::ScheduleEvent(endVBlank);
 
+		mPrimitiveBatch.clear();
 		mRenderer->Reset();
 	}
 
@@ -479,6 +587,7 @@ namespace esx {
 
 		Color color = unpackColor(command & 0xFFFFFF);
 
+		submitPrimitives();
 		mRenderer->Clear(XPos, YPos, XSiz, YSiz, color);
 	}
 
@@ -570,13 +679,17 @@ namespace esx {
 				vertex.semiTransparency = semiTransparent ? (U8)semiTransparency : 255;
 
 				transformUV(vertex.uv, tx, ty, vertex.bpp);
+				transformUV(vertex.texPage, tx, ty, vertex.bpp);
 				vertex.clutUV = UV(cx, cy);
 
 			}
 		}
 
 		//ESX_CORE_LOG_TRACE("GPU::gp0DrawPolygonPrimitiveCommand");
-		mRenderer->DrawPolygon(vertices, numVertices);
+		mPrimitiveBatch.push(PrimitiveType::Polygon, vertices.data(), numVertices);
+		if (mPrimitiveBatch.size() >= MAX_BATCH_PRIMITIVES) {
+			submitPrimitives();
+		}
 
 	}
 
@@ -619,7 +732,12 @@ namespace esx {
 			mCommandBuffer.pop(); //Pop terminator
 		} 
 
-		Vector<PolygonVertex> vertices(numVertices);
+		//Vertices are parsed straight into the batch
+		size_t firstVertex = mPrimitiveBatch.Vertices.size();
+		mPrimitiveBatch.Primitives.emplace_back(Primitive{ PrimitiveType::LineStrip, (U32)firstVertex, numVertices });
+		mPrimitiveBatch.Vertices.resize(firstVertex + numVertices);
+
+		PolygonVertex* vertices = &mPrimitiveBatch.Vertices[firstVertex];
 		for (I32 i = numVertices - 1; i >= 0; i--) {
 			vertices[i].vertex = unpackVertex(mCommandBuffer.pop());
 			vertices[i].color = (gourad && i > 0) ? unpackColor(mCommandBuffer.pop()) : flatColor;
@@ -628,7 +746,9 @@ namespace esx {
 		}
 
 		//ESX_CORE_LOG_TRACE("GPU::gp0DrawLinePrimitiveCommand");
-		mRenderer->DrawLineStrip(vertices);
+		if (mPrimitiveBatch.size() >= MAX_BATCH_PRIMITIVES) {
+			submitPrimitives();
+		}
 	}
 
 	Command GPU::gp0RectanglePrimitiveCommands(U32 instruction) const
@@ -714,11 +834,15 @@ namespace esx {
 
 			for (PolygonVertex& vertex : vertices) {
 				transformUV(vertex.uv, tx, ty, bpp);
+				transformUV(vertex.texPage, tx, ty, bpp);
 			}
 		}
 
 		//ESX_CORE_LOG_TRACE("GPU::gp0DrawRectanglePrimitiveCommand");
-		mRenderer->DrawPolygon(vertices, 4);
+		mPrimitiveBatch.push(PrimitiveType::Polygon, vertices.data(), 4);
+		if (mPrimitiveBatch.size() >= MAX_BATCH_PRIMITIVES) {
+			submitPrimitives();
+		}
 	}
 
 	Command GPU::gp0VRAMtoVRAMBlitCommands(U32 instruction) const
@@ -752,12 +876,8 @@ namespace esx {
 		mMemoryTransferX = 0;
 		mMemoryTransferY = 0;
 
-		mPixelsToTransfer.reserve(mMemoryTransferWidth * mMemoryTransferHeight);
-		mPixelsToTransfer.resize(0);
-		mPixelsToTransfer.clear();
-
-		mRenderer->VRAMRead(mMemoryTransferSourceCoordsX, mMemoryTransferSourceCoordsY, mMemoryTransferWidth, mMemoryTransferHeight, mPixelsToTransfer);
-		mRenderer->VRAMWrite(mMemoryTransferDestinationCoordsX, mMemoryTransferDestinationCoordsY, mMemoryTransferWidth, mMemoryTransferHeight, mPixelsToTransfer);
+		submitPrimitives();
+		mRenderer->VRAMCopy(mMemoryTransferSourceCoordsX, mMemoryTransferSourceCoordsY, mMemoryTransferDestinationCoordsX, mMemoryTransferDestinationCoordsY, mMemoryTransferWidth, mMemoryTransferHeight);
 	}
 
 	Command GPU::gp0CPUtoVRAMBlitCommands(U32 instruction) const
@@ -830,11 +950,22 @@ namespace esx {
 		mPixelsToTransfer.resize(0);
 		mPixelsToTransfer.clear();
 
-		mRenderer->VRAMRead(mMemoryTransferSourceCoordsX, mMemoryTransferSourceCoordsY, mMemoryTransferWidth, mMemoryTransferHeight, mPixelsToTransfer);
+		submitPrimitives();
+
+		//Pixels are fetched on the first GPUREAD so the readback overlaps with the CPU
+		mRenderer->RequestVRAMRead(mMemoryTransferSourceCoordsX, mMemoryTransferSourceCoordsY, mMemoryTransferWidth, mMemoryTransferHeight);
+		mVRAMReadPending = ESX_TRUE;
 
 		mGPUStat.ReadySendVRAMToCPU = ESX_TRUE;
 	}
 
+	void GPU::resolveVRAMRead()
+	{
+		submitPrimitives();
+		mRenderer->VRAMRead(mMemoryTransferSourceCoordsX, mMemoryTransferSourceCoordsY, mMemoryTransferWidth, mMemoryTransferHeight, mPixelsToTransfer);
+		mVRAMReadPending = ESX_FALSE;
+	}
+
 	Command GPU::gp0EnvironmentCommands(U32 instruction) const
 	{
 		U8 command = (instruction >> 24) & 0xFF;
@@ -914,6 +1045,7 @@ namespace esx {
 		mDrawAreaTopLeftX = (instruction >> 0) & 0x3FF;
 		mDrawAreaTopLeftY = (instruction >> 10) & 0x3FF;
 
+		submitPrimitives();
 		mRenderer->SetDrawTopLeft(mDrawAreaTopLeftX, mDrawAreaTopLeftY);
 	}
 
@@ -923,6 +1055,7 @@ namespace esx {
 		mDrawAreaBottomRightX = (instruction >> 0) & 0x3FF;
 		mDrawAreaBottomRightY = (instruction >> 10) & 0x3FF;
 
+		submitPrimitives();
 		mRenderer->SetDrawBottomRight(mDrawAreaBottomRightX, mDrawAreaBottomRightY);
 	}
 
@@ -936,6 +1069,7 @@ namespace esx {
 		mDrawOffsetX = ((I16)(drawOffsetX << 5)) >> 5;
 		mDrawOffsetY = ((I16)(drawOffsetY << 5)) >> 5;
 
+		submitPrimitives();
 		mRenderer->SetDrawOffset(mDrawOffsetX, mDrawOffsetY);
 	}
 
@@ -945,6 +1079,7 @@ namespace esx {
 		mGPUStat.SetMaskWhenDrawingPixels = (instruction >> 0) & 0x1;
 		mGPUStat.DrawPixels = (instruction >> 1) & 0x1;
 
+		submitPrimitives();
 		mRenderer->SetForceAlpha(mGPUStat.SetMaskWhenDrawingPixels);
 		mRenderer->SetCheckMask(mGPUStat.DrawPixels);
 	}
@@ -1091,6 +1226,7 @@ namespace esx {
 		mGPUStat.VerticalInterlace = (instruction >> 5) & 0x1;
 		mGPUStat.ReverseFlag = (instruction >> 7) & 0x1;
 
+		submitPrimitives();
 		mRenderer->SetDisplayMode24(mGPUStat.ColorDepth == ColorDepth::C24Bit);
 	}
 
@@ -5,6 +5,8 @@
 
 #include <Core/IRenderer.h>
 
+#include <chrono>
+
 namespace esx {
 
 	class GPU;
@@ -21,6 +23,8 @@ namespace esx {
 		constexpr U64 CLOCKS_PER_SCANLINE = 3413;
 	#endif
 
+	constexpr size_t MAX_BATCH_PRIMITIVES = 1024;
+
 	constexpr Array<U64, 7> DOT_CLOCKS = {
 		10,
 		8,
@@ -68,6 +72,12 @@ namespace esx {
 		C24Bit = 1
 	};
 
+	enum class FrameSkipMode : U8 {
+		Off,
+		Fixed,
+		Auto
+	};
+
 	enum class DMADirection : U8 {
 		Off = 0,
 		FIFO = 1,
@@ -147,6 +157,7 @@ namespace esx {
 		void load(const StringView& busName, U32 address, U32& output) override;
 
 		void gp0(U32 instruction);
+		void gp0Batch(const U32* instructions, size_t count);
 		void gp1(U32 instruction);
 		U32 gpuRead();
 
@@ -167,9 +178,24 @@ namespace esx {
 			return tempFrame;
 		}
 
+		//Skipped frames complete without becoming available
+		BIT isFrameComplete() {
+			BIT tempFrame = mFrameComplete;
+			if(mFrameComplete) mFrameComplete = ESX_FALSE;
+			return tempFrame;
+		}
+
 		U64 GetDotClocks() { return DOT_CLOCKS[(U8)mGPUStat.HorizontalResolution]; }
 		U64 GetClocksPerScanline() { return mClocksPerScanline; }
 
+		void setFrameSkip(FrameSkipMode mode, U32 frames) { mFrameSkipMode = mode; mFrameSkip = frames; mSkippedFrames = 0; mFrameLag = 0.0; }
+		FrameSkipMode getFrameSkipMode() const { return mFrameSkipMode; }
+		U32 getFrameSkip() const { return mFrameSkip; }
+
+		//Turbo only draws every frames-th emulated frame, 0 draws at most one per host refresh
+		void setTurbo(U32 frames) { mTurboFrames = frames; mSkippedFrames = 0; mTurboElapsed = 0.0; }
+		U32 getTurbo() const { return mTurboFrames; }
+
 
 		static U64 ToGPUClock(U64 cpuClocks) { return (cpuClocks * 11) / 7; }
 		static constexpr U64 FromGPUClock(U64 gpuClock) { return (gpuClock * 7) / 11; }
@@ -205,6 +231,7 @@ namespace esx {
 		//VRAM to CPU blitting
 		Command gp0VRAMtoCPUBlitCommands(U32 instruction) const;
 		void gp0VRAMtoCPUBlitCommand();
+		void resolveVRAMRead();
 
 		//Environment commands
 		Command gp0EnvironmentCommands(U32 instruction) const;
@@ -231,6 +258,10 @@ namespace esx {
 		void gp1SetTextureDisableSpecial(U32 instruction);
 
 		U32 getGPUStat();
+		BIT shouldSkipFrame();
+		void submitPrimitives();
+		U16 getDisplayWidth() const;
+		U16 getDisplayHeight() const;
 
 		static HorizontalResolution fromFields(U8 hr1, U8 hr2);
 		static Vertex unpackVertex(U32 value);
@@ -285,6 +316,7 @@ namespace esx {
 		U16 mMemoryTransferHeight = 0x0000;
 		U16 mMemoryTransferVRAMToCPU = 0x0000;
 		Vector<VRAMColor> mPixelsToTransfer = {};
+		BIT mVRAMReadPending = ESX_FALSE;
 		U32 mNumWordsToTransfer = 0x00000000;
 		U32 mCurrentWordNumber = 0x00000000;
 
@@ -292,8 +324,19 @@ namespace esx {
 		U64 mCurrentScanLine = 0;
 
 		BIT mFrameAvailable = ESX_FALSE;
+		BIT mFrameComplete = ESX_FALSE;
+
+		FrameSkipMode mFrameSkipMode = FrameSkipMode::Off;
+		U32 mFrameSkip = 1;
+		U32 mSkippedFrames = 0;
+		BIT mSkipFrame = ESX_FALSE;
+		F64 mFrameLag = 0.0;
+		std::chrono::steady_clock::time_point mLastFrameTime = {};
+		U32 mTurboFrames = 1;
+		F64 mTurboElapsed = 0.0;
 
 		SharedPtr<IRenderer> mRenderer = {};
+		PrimitiveBatch mPrimitiveBatch = {};
 		SharedPtr<Timer> mTimer = {};
 		SharedPtr<InterruptControl> mInterruptControl = {};
 		SharedPtr<R3000> mCPU = {};
@@ -61,6 +61,11 @@ namespace esx {
 		U8 semiTransparency = 0x00;
 		U8 dither = 0x00;
 		U8 rawTexture = 0x00;
+		UV drawTopLeft;
+		UV drawBottomRight;
+		U8 forceAlpha = 0x00;
+		U8 checkMask = 0x00;
+		UV texPage;
 	};
 
 
@@ -70,6 +75,36 @@ namespace esx {
 
 	constexpr size_t p = sizeof(VRAMColor);
 
+	enum class PrimitiveType : U8 {
+		Polygon,
+		LineStrip
+	};
+
+	struct Primitive {
+		PrimitiveType Type = PrimitiveType::Polygon;
+		U32 FirstVertex = 0;
+		U32 NumVertices = 0;
+	};
+
+	//Primitives parsed from GP0 in submission order, their vertices packed back to back
+	struct PrimitiveBatch {
+		Vector<PolygonVertex> Vertices;
+		Vector<Primitive> Primitives;
+
+		void push(PrimitiveType type, const PolygonVertex* vertices, U32 numVertices) {
+			Primitives.emplace_back(Primitive{ type, (U32)Vertices.size(), numVertices });
+			Vertices.insert(Vertices.end(), vertices, vertices + numVertices);
+		}
+
+		void clear() {
+			Vertices.clear();
+			Primitives.clear();
+		}
+
+		BIT empty() const { return Primitives.empty(); }
+		size_t size() const { return Primitives.size(); }
+	};
+
 	class IRenderer {
 	public:
 		virtual ~IRenderer() = default;
@@ -83,14 +118,19 @@ namespace esx {
 		virtual void SetForceAlpha(BIT value) = 0;
 		virtual void SetCheckMask(BIT value) = 0;
 		virtual void SetDisplayMode24(BIT value) = 0;
+		virtual void SetSkipRendering(BIT value) = 0;
 		virtual void Clear(U16 x, U16 y, U16 w, U16 h, Color& color) = 0;
 		virtual void DrawPolygon(Array<PolygonVertex, 4>& vertices, U32 numVertices) = 0;
 		virtual void DrawLineStrip(Vector<PolygonVertex>& vertices) = 0;
+		virtual void Submit(PrimitiveBatch& batch) = 0;
 
 		virtual void Reset() = 0;
 
 		virtual void VRAMWrite(U16 x, U16 y, U32 width, U32 height, const Vector<VRAMColor>& pixels) = 0;
 		virtual void VRAMRead(U16 x, U16 y, U32 width, U32 height, Vector<VRAMColor>& pixels) = 0;
+		virtual void RequestVRAMRead(U16 x, U16 y, U32 width, U32 height) = 0;
+		virtual void VRAMCopy(U16 srcX, U16 srcY, U16 dstX, U16 dstY, U32 width, U32 height) = 0;
+		virtual void ResolveArea(U16 x, U16 y, U32 width, U32 height) = 0;
 
 		static VRAMColor fromU16(U16 value) {
 			VRAMColor color;
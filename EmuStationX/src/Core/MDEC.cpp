@@ -1,17 +1,250 @@
 #include "MDEC.h"
 
+#include <chrono>
+#include <random>
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#define ESX_MDEC_SSE2
+	#include <emmintrin.h>
+#endif
+
 namespace esx {
 
+	static void fast_idct_pass(const I16* src, I16* dst)
+	{
+		for (I32 i = 0; i < 8; i++) {
+			BIT isColumnZero = ESX_TRUE;
+			for (I32 k = 0; k < 8; k++) {
+				if (src[k * 8 + i] != 0) {
+					isColumnZero = ESX_FALSE;
+					break;
+				}
+			}
+
+			if (isColumnZero) {
+				for (I32 k = 0; k < 8; k++) {
+					dst[i * 8 + k] = src[0 * 8 + i];
+				}
+			}
+			else {
+				F32 z10 = src[0 * 8 + i] + src[4 * 8 + i]; F32 z11 = src[0 * 8 + i] - src[4 * 8 + i];
+				F32 z13 = src[2 * 8 + i] + src[6 * 8 + i]; F32 z12 = src[2 * 8 + i] - src[6 * 8 + i];
+				z12 = (1.414213562f * z12) - z13;
+
+				F32 tmp0 = z10 + z13; F32 tmp3 = z10 - z13; F32 tmp1 = z11 + z12; F32 tmp2 = z11 - z12;
+				z13 = src[3 * 8 + i] + src[5 * 8 + i]; z10 = src[3 * 8 + i] - src[5 * 8 + i];
+				z11 = src[1 * 8 + i] + src[7 * 8 + i]; z12 = src[1 * 8 + i] - src[7 * 8 + i];
+				F32 z5 = (1.847759065f * (z12 - z10));
+
+				F32 tmp7 = z11 + z13;
+				F32 tmp6 = (2.613125930f * (z10)) + z5 - tmp7;
+				F32 tmp5 = (1.414213562f * (z11 - z13)) - tmp6;
+				F32 tmp4 = (1.082392200f * (z12)) - z5 + tmp5;
+				dst[i * 8 + 0] = tmp0 + tmp7; dst[i * 8 + 7] = tmp0 - tmp7;
+				dst[i * 8 + 1] = tmp1 + tmp6; dst[i * 8 + 6] = tmp1 - tmp6;
+				dst[i * 8 + 2] = tmp2 + tmp5; dst[i * 8 + 5] = tmp2 - tmp5;
+				dst[i * 8 + 4] = tmp3 + tmp4; dst[i * 8 + 3] = tmp3 - tmp4;
+			}
+		}
+	}
+
+	static void yuv_to_rgb_block(const I16* Crblk, const I16* Cbblk, const I16* Yblk, U64 xx, U64 yy, BIT outputSigned, MDECRGB* out)
+	{
+		for (I32 y = 0; y < 8; y++) {
+			for (I32 x = 0; x < 8; x++) {
+				U64 index = ((x + xx) / 2) + ((y + yy) / 2) * 8;
+				I16 R = Crblk[index];
+				I16 B = Cbblk[index];
+				I16 G = static_cast<I16>((-0.3437f * static_cast<F32>(B)) + (-0.7143f * static_cast<F32>(R)));
+
+				R = static_cast<I16>((1.402f * static_cast<F32>(R)));
+				B = static_cast<I16>((1.772f * static_cast<F32>(B)));
+
+				I16 Y = Yblk[x + y * 8];
+				R = std::clamp<I16>(Y + R, -128, 127);
+				G = std::clamp<I16>(Y + G, -128, 127);
+				B = std::clamp<I16>(Y + B, -128, 127);
+
+				if (outputSigned == ESX_FALSE) {
+					R ^= 0x80;
+					G ^= 0x80;
+					B ^= 0x80;
+				}
+
+				out[(x + xx) + (y + yy) * 16].R = R;
+				out[(x + xx) + (y + yy) * 16].G = G;
+				out[(x + xx) + (y + yy) * 16].B = B;
+			}
+		}
+	}
+
+	//Packs 8 pixels into 4 output words of two 15-bit pixels each
+	static void pack_15bit(const MDECRGB* src, U16 a, U32* dst)
+	{
+		for (I32 i = 0; i < 4; i++) {
+			const MDECRGB& rgb1 = src[i * 2 + 0];
+			U8 r = (rgb1.R >> 3) & 0x1F;
+			U8 g = (rgb1.G >> 3) & 0x1F;
+			U8 b = (rgb1.B >> 3) & 0x1F;
+			U16 pixel1 = (a << 15) | (b << 10) | (g << 5) | r;
+
+			const MDECRGB& rgb2 = src[i * 2 + 1];
+			r = (rgb2.R >> 3) & 0x1F;
+			g = (rgb2.G >> 3) & 0x1F;
+			b = (rgb2.B >> 3) & 0x1F;
+			U16 pixel2 = (a << 15) | (b << 10) | (g << 5) | r;
+
+			dst[i] = (U32(pixel2) << 16) | pixel1;
+		}
+	}
+
+#ifdef ESX_MDEC_SSE2
+	//Float -> I16 with the same truncate-then-wrap behaviour as the scalar static_cast
+	static inline __m128i cvtt_wrap_i16(__m128 a, __m128 b)
+	{
+		__m128i lo = _mm_srai_epi32(_mm_slli_epi32(_mm_cvttps_epi32(a), 16), 16);
+		__m128i hi = _mm_srai_epi32(_mm_slli_epi32(_mm_cvttps_epi32(b), 16), 16);
+		return _mm_packs_epi32(lo, hi);
+	}
+
+	static inline __m128 load_i16x4(const I16* src)
+	{
+		__m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+		return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+	}
+
+	//Same per-lane operation order as fast_idct_core so results are bit identical, four columns at a time
+	static void fast_idct_pass_sse2(const I16* src, I16* dst)
+	{
+		const __m128 c1414 = _mm_set1_ps(1.414213562f);
+		const __m128 c1847 = _mm_set1_ps(1.847759065f);
+		const __m128 c2613 = _mm_set1_ps(2.613125930f);
+		const __m128 c1082 = _mm_set1_ps(1.082392200f);
+
+		for (I32 i = 0; i < 8; i += 4) {
+			__m128 s0 = load_i16x4(&src[0 * 8 + i]); __m128 s1 = load_i16x4(&src[1 * 8 + i]);
+			__m128 s2 = load_i16x4(&src[2 * 8 + i]); __m128 s3 = load_i16x4(&src[3 * 8 + i]);
+			__m128 s4 = load_i16x4(&src[4 * 8 + i]); __m128 s5 = load_i16x4(&src[5 * 8 + i]);
+			__m128 s6 = load_i16x4(&src[6 * 8 + i]); __m128 s7 = load_i16x4(&src[7 * 8 + i]);
+
+			__m128 z10 = _mm_add_ps(s0, s4); __m128 z11 = _mm_sub_ps(s0, s4);
+			__m128 z13 = _mm_add_ps(s2, s6); __m128 z12 = _mm_sub_ps(s2, s6);
+			z12 = _mm_sub_ps(_mm_mul_ps(c1414, z12), z13);
+
+			__m128 tmp0 = _mm_add_ps(z10, z13); __m128 tmp3 = _mm_sub_ps(z10, z13);
+			__m128 tmp1 = _mm_add_ps(z11, z12); __m128 tmp2 = _mm_sub_ps(z11, z12);
+			z13 = _mm_add_ps(s3, s5); z10 = _mm_sub_ps(s3, s5);
+			z11 = _mm_add_ps(s1, s7); z12 = _mm_sub_ps(s1, s7);
+			__m128 z5 = _mm_mul_ps(c1847, _mm_sub_ps(z12, z10));
+
+			__m128 tmp7 = _mm_add_ps(z11, z13);
+			__m128 tmp6 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(c2613, z10), z5), tmp7);
+			__m128 tmp5 = _mm_sub_ps(_mm_mul_ps(c1414, _mm_sub_ps(z11, z13)), tmp6);
+			__m128 tmp4 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(c1082, z12), z5), tmp5);
+
+			__m128 o0 = _mm_add_ps(tmp0, tmp7); __m128 o7 = _mm_sub_ps(tmp0, tmp7);
+			__m128 o1 = _mm_add_ps(tmp1, tmp6); __m128 o6 = _mm_sub_ps(tmp1, tmp6);
+			__m128 o2 = _mm_add_ps(tmp2, tmp5); __m128 o5 = _mm_sub_ps(tmp2, tmp5);
+			__m128 o4 = _mm_add_ps(tmp3, tmp4); __m128 o3 = _mm_sub_ps(tmp3, tmp4);
+
+			//Lanes hold columns, the output is written transposed
+			_MM_TRANSPOSE4_PS(o0, o1, o2, o3);
+			_MM_TRANSPOSE4_PS(o4, o5, o6, o7);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[(i + 0) * 8]), cvtt_wrap_i16(o0, o4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[(i + 1) * 8]), cvtt_wrap_i16(o1, o5));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[(i + 2) * 8]), cvtt_wrap_i16(o2, o6));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[(i + 3) * 8]), cvtt_wrap_i16(o3, o7));
+		}
+	}
+
+	static void yuv_to_rgb_sse2(const I16* Crblk, const I16* Cbblk, const I16* Yblk, U64 xx, U64 yy, BIT outputSigned, MDECRGB* out)
+	{
+		const __m128 cG0 = _mm_set1_ps(-0.3437f);
+		const __m128 cG1 = _mm_set1_ps(-0.7143f);
+		const __m128 cR = _mm_set1_ps(1.402f);
+		const __m128 cB = _mm_set1_ps(1.772f);
+		const __m128i minValue = _mm_set1_epi16(-128);
+		const __m128i maxValue = _mm_set1_epi16(127);
+		const __m128i flip = _mm_set1_epi16(outputSigned ? 0 : 0x80);
+		const __m128i byteMask = _mm_set1_epi16(0xFF);
+		const __m128i keepMask = _mm_set1_epi32(0xFF000000);
+
+		for (I32 y = 0; y < 8; y++) {
+			U64 chromaIndex = (xx / 2) + ((y + yy) / 2) * 8;
+			__m128 Cr = load_i16x4(&Crblk[chromaIndex]);
+			__m128 Cb = load_i16x4(&Cbblk[chromaIndex]);
+
+			//4 chroma samples, each shared by two horizontal pixels
+			__m128i R = cvtt_wrap_i16(_mm_mul_ps(cR, Cr), _mm_setzero_ps());
+			__m128i G = cvtt_wrap_i16(_mm_add_ps(_mm_mul_ps(cG0, Cb), _mm_mul_ps(cG1, Cr)), _mm_setzero_ps());
+			__m128i B = cvtt_wrap_i16(_mm_mul_ps(cB, Cb), _mm_setzero_ps());
+			R = _mm_unpacklo_epi16(R, R);
+			G = _mm_unpacklo_epi16(G, G);
+			B = _mm_unpacklo_epi16(B, B);
+
+			__m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[y * 8]));
+			R = _mm_xor_si128(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, R), minValue), maxValue), flip);
+			G = _mm_xor_si128(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, G), minValue), maxValue), flip);
+			B = _mm_xor_si128(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, B), minValue), maxValue), flip);
+
+			__m128i RG = _mm_or_si128(_mm_and_si128(R, byteMask), _mm_slli_epi16(_mm_and_si128(G, byteMask), 8));
+			B = _mm_and_si128(B, byteMask);
+
+			//Only R, G and B are written by the scalar path, the top byte is left as it was
+			__m128i* dst = reinterpret_cast<__m128i*>(&out[xx + (y + yy) * 16]);
+			__m128i lo = _mm_or_si128(_mm_unpacklo_epi16(RG, B), _mm_and_si128(_mm_loadu_si128(dst + 0), keepMask));
+			__m128i hi = _mm_or_si128(_mm_unpackhi_epi16(RG, B), _mm_and_si128(_mm_loadu_si128(dst + 1), keepMask));
+			_mm_storeu_si128(dst + 0, lo);
+			_mm_storeu_si128(dst + 1, hi);
+		}
+	}
+
+	static void pack_15bit_sse2(const MDECRGB* src, U16 a, U32* dst)
+	{
+		const __m128i fiveBits = _mm_set1_epi32(0x1F);
+		const __m128i alpha = _mm_set1_epi32(a << 15);
+
+		__m128i pixels[2];
+		for (I32 i = 0; i < 2; i++) {
+			__m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i * 4]));
+			__m128i r = _mm_and_si128(_mm_srli_epi32(words, 3), fiveBits);
+			__m128i g = _mm_and_si128(_mm_srli_epi32(words, 11), fiveBits);
+			__m128i b = _mm_and_si128(_mm_srli_epi32(words, 19), fiveBits);
+			__m128i pixel = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 5)), _mm_or_si128(_mm_slli_epi32(b, 10), alpha));
+			pixels[i] = _mm_srai_epi32(_mm_slli_epi32(pixel, 16), 16);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packs_epi32(pixels[0], pixels[1]));
+	}
+#endif
+
+	//The scalar kernels are always built, they are the reference the SIMD ones are checked against
+	struct MDECKernels {
+		void (*IDCTPass)(const I16* src, I16* dst);
+		void (*YUVToRGB)(const I16* Crblk, const I16* Cbblk, const I16* Yblk, U64 xx, U64 yy, BIT outputSigned, MDECRGB* out);
+		void (*Pack15Bit)(const MDECRGB* src, U16 a, U32* dst);
+	};
+
+	static constexpr MDECKernels SCALAR_KERNELS = { fast_idct_pass, yuv_to_rgb_block, pack_15bit };
+#ifdef ESX_MDEC_SSE2
+	static constexpr MDECKernels SSE2_KERNELS = { fast_idct_pass_sse2, yuv_to_rgb_sse2, pack_15bit_sse2 };
+	static constexpr const MDECKernels* DEFAULT_KERNELS = &SSE2_KERNELS;
+#else
+	static constexpr const MDECKernels* DEFAULT_KERNELS = &SCALAR_KERNELS;
+#endif
+
 
 
 	MDEC::MDEC()
-		: BusDevice(ESX_TEXT("MDEC"))
+		: BusDevice(ESX_TEXT("MDEC")), mKernels(DEFAULT_KERNELS)
 	{
 		addRange(ESX_TEXT("Root"), 0x1F801820, BYTE(8), 0xFFFFFFFF);
 	}
 
 	MDEC::~MDEC()
 	{
+		setPipelined(ESX_FALSE);
 	}
 
 	void MDEC::clock(U64 clocks)
@@ -22,6 +255,7 @@ namespace esx {
 	{
 		switch (address) {
 			case 0x1F801820: {
+				record(&value, 1);
 				setCommandOrParameters(value);
 				break;
 			}
@@ -50,6 +284,8 @@ namespace esx {
 
 	void MDEC::reset()
 	{
+		stopPipeline();
+
 		mStatusRegister = {};
 		mControlRegister = {};
 		mCurrentCommand = MDECCommand::None;
@@ -66,47 +302,399 @@ namespace esx {
 
 	void MDEC::channelIn(U32 word)
 	{
+		record(&word, 1);
 		setCommandOrParameters(word);
 	}
 
+	void MDEC::channelIn(const U32* input, U32 numWords)
+	{
+		record(input, numWords);
+
+		while (numWords > 0) {
+			BIT collecting = mStatusRegister.NumberOfParameterWords != 0xFFFF && mCurrentCommand != MDECCommand::NoFunction && mCurrentCommand != MDECCommand::None;
+
+			//Parameter words that do not complete the command are appended as one run
+			U32 count = collecting ? std::min<U32>(numWords, mStatusRegister.NumberOfParameterWords) : 0;
+			if (count > 0) {
+				stopPipeline();
+
+				if (mDataIn.push_back(input, count) != count) {
+					ESX_CORE_LOG_WARNING("MDEC - Input FIFO overflow");
+				}
+				mStatusRegister.NumberOfParameterWords -= count;
+			} else {
+				setCommandOrParameters(*input);
+				count = 1;
+			}
+
+			input += count;
+			numWords -= count;
+		}
+	}
+
 	U32 MDEC::channelOut()
 	{
 		U32 word = 0;
+		channelOut(&word, 1);
+		return word;
+	}
+
+	void MDEC::channelOut(U32* output, U32 numWords)
+	{
+		while (numWords > 0) {
+			//Drain the decoded macroblock in one go, an empty FIFO reads as zero
+			U32 count = (U32)mDataOut.pop_front(output, numWords);
+			if (count == 0) {
+				*output = 0;
+				count = 1;
+			}
+			output += count;
+			numWords -= count;
+
+			if (mDataOut.size() == 0 && mDecoding) {
+				pullMacroblock();
+				if (!mDecoding) {
+					mDataIn.clear();
+					mStatusRegister.DataInFIFOFull = ESX_FALSE;
+				}
+			}
+		}
+
+		mStatusRegister.DataOutFIFOEmpty = mDataOut.size() == 0;
+	}
+
+	void MDEC::setPipelined(BIT pipelined)
+	{
+		if (pipelined == mPipelined) return;
+
+		if (pipelined) {
+			mWorkerState = MDECWorkerState::Idle;
+			mWorker = std::thread(&MDEC::workerLoop, this);
+		} else {
+			stopPipeline();
+
+			mWorkerState = MDECWorkerState::Quit;
+			mWorkerState.notify_one();
+			mWorker.join();
+		}
+
+		mPipelined = pipelined;
+	}
+
+	void MDEC::startRecording(const std::filesystem::path& path)
+	{
+		stopRecording();
+
+		mRecordStream.open(path, std::ios::binary);
+		if (!mRecordStream.is_open()) {
+			ESX_CORE_LOG_ERROR("MDEC - Unable to open {} for recording", path.string());
+			return;
+		}
+
+		std::error_code error;
+		std::filesystem::remove(GetBenchmarkHashPath(path), error);
+	}
+
+	void MDEC::stopRecording()
+	{
+		if (mRecordStream.is_open()) {
+			mRecordStream.close();
+		}
+	}
+
+	void MDEC::record(const U32* words, U32 numWords)
+	{
+		if (mRecordStream.is_open()) {
+			mRecordStream.write(reinterpret_cast<const char*>(words), numWords * sizeof(U32));
+		}
+	}
+
+	std::filesystem::path MDEC::GetBenchmarkHashPath(const std::filesystem::path& path)
+	{
+		return std::filesystem::path(path).replace_extension(".hashes");
+	}
+
+	Optional<MDECBenchmarkResult> MDEC::LoadBenchmarkHashes(const std::filesystem::path& path)
+	{
+		std::ifstream input(path);
+		if (!input.is_open()) return {};
+
+		//One line per output depth: depth, macroblocks and hash in hex
+		MDECBenchmarkResult result = {};
+		U32 depth = 0;
+		U64 macroblocks = 0;
+		U64 hash = 0;
+		while (input >> std::dec >> depth >> macroblocks >> std::hex >> hash) {
+			if (depth >= result.DepthHashes.size()) {
+				ESX_CORE_LOG_ERROR("MDEC - {} is malformed", path.string());
+				return {};
+			}
+			result.DepthMacroblocks[depth] = macroblocks;
+			result.DepthHashes[depth] = hash;
+			result.Macroblocks += macroblocks;
+		}
+
+		if (!input.eof()) {
+			ESX_CORE_LOG_ERROR("MDEC - {} is malformed", path.string());
+			return {};
+		}
+
+		return result;
+	}
+
+	BIT MDEC::SaveBenchmarkHashes(const std::filesystem::path& path, const MDECBenchmarkResult& result)
+	{
+		std::ofstream output(path, std::ios::trunc);
+		for (U32 depth = 0; depth < result.DepthHashes.size(); depth++) {
+			output << std::dec << depth << " " << result.DepthMacroblocks[depth] << " " << std::hex << result.DepthHashes[depth] << "\n";
+		}
+
+		if (output.fail()) {
+			ESX_CORE_LOG_ERROR("MDEC - Unable to write {}", path.string());
+			return ESX_FALSE;
+		}
+
+		return ESX_TRUE;
+	}
 
-		if (mDataOut.size() != 0) {
-			word = mDataOut.front();
-			mDataOut.pop_front();
+	Optional<MDECBenchmarkResult> MDEC::Benchmark(const std::filesystem::path& path, U32 iterations, BIT pipelined)
+	{
+		std::ifstream input(path, std::ios::binary | std::ios::ate);
+		if (!input.is_open()) {
+			ESX_CORE_LOG_ERROR("MDEC - Unable to open {} for benchmarking", path.string());
+			return {};
 		}
 
-		if (mDataOut.size() == 0 && mDecoding) {
-			switch (mStatusRegister.DataOutputDepth) {
-				case MDECOutputDepth::Bit15:
-				case MDECOutputDepth::Bit24: {
-					if (!decode_colored_macroblock()) {
-						mDecoding = ESX_FALSE;
+		Vector<U32> stream(static_cast<size_t>(input.tellg()) / sizeof(U32));
+		input.seekg(0);
+		input.read(reinterpret_cast<char*>(stream.data()), stream.size() * sizeof(U32));
+
+		MDECBenchmarkResult result = {};
+		result.DepthHashes.fill(0xCBF29CE484222325);
+#ifdef ESX_MDEC_SSE2
+		result.KernelsCompared = ESX_TRUE;
+		result.KernelMismatches = CompareKernels(stream);
+#endif
+		Array<U32, MAX_OUTPUT_WORDS> output = {};
+
+		auto start = std::chrono::steady_clock::now();
+		for (U32 iteration = 0; iteration < iterations; iteration++) {
+			SharedPtr<MDEC> mdec = MakeShared<MDEC>();
+			mdec->setPipelined(pipelined);
+
+			for (U32 word : stream) {
+				mdec->setCommandOrParameters(word);
+
+				//Read the whole command back one macroblock at a time, the FIFO holds exactly one
+				while (mdec->mDataOut.size() > 0) {
+					U8 depth = static_cast<U8>(mdec->mStatusRegister.DataOutputDepth);
+					U32 count = static_cast<U32>(mdec->mDataOut.size());
+					mdec->channelOut(output.data(), count);
+
+					//FNV-1a over the output words, the first pass is enough to catch a mismatch
+					if (iteration == 0) {
+						U64& hash = result.DepthHashes[depth];
+						for (U32 i = 0; i < count; i++) {
+							hash = (hash ^ output[i]) * 0x100000001B3;
+						}
+						result.DepthMacroblocks[depth]++;
 					}
-					break;
+					result.Macroblocks++;
 				}
+			}
+		}
+		result.Seconds = std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count();
 
-				case MDECOutputDepth::Bit8:
-				case MDECOutputDepth::Bit4: {
-					if (!decode_monochrome_macroblock()) {
-						mDecoding = ESX_FALSE;
-					}
-					break;
+		return result;
+	}
+
+	U64 MDEC::CompareKernels(const Vector<U32>& stream)
+	{
+		U64 mismatches = 0;
+
+#ifdef ESX_MDEC_SSE2
+		//Random blocks exercise each kernel on its own, the fixed seed keeps failures reproducible
+		constexpr U32 RANDOM_BLOCKS = 4096;
+		std::mt19937 random(0x4D444543);
+		std::uniform_int_distribution<I32> coefficient(-1024, 1023);
+		std::uniform_int_distribution<U32> word(0, UINT32_MAX);
+
+		for (U32 i = 0; i < RANDOM_BLOCKS; i++) {
+			Array<I16, 64> block = {};
+			Array<I16, 64> expectedBlock = {};
+			Array<I16, 64> actualBlock = {};
+			for (I16& value : block) value = static_cast<I16>((i % 4 == 0 && (word(random) & 3) != 0) ? 0 : coefficient(random));
+			SCALAR_KERNELS.IDCTPass(block.data(), expectedBlock.data());
+			SSE2_KERNELS.IDCTPass(block.data(), actualBlock.data());
+			if (expectedBlock != actualBlock) mismatches++;
+
+			Array<Array<I16, 64>, 3> yuv = {};
+			for (Array<I16, 64>& component : yuv) {
+				for (I16& value : component) value = static_cast<I16>(coefficient(random));
+			}
+			Array<MDECRGB, 256> expectedRGB = {};
+			for (MDECRGB& rgb : expectedRGB) rgb.WORD = word(random);
+			Array<MDECRGB, 256> actualRGB = expectedRGB;
+			U64 xx = (i & 1) * 8;
+			U64 yy = ((i >> 1) & 1) * 8;
+			BIT outputSigned = (i >> 2) & 1;
+			SCALAR_KERNELS.YUVToRGB(yuv[0].data(), yuv[1].data(), yuv[2].data(), xx, yy, outputSigned, expectedRGB.data());
+			SSE2_KERNELS.YUVToRGB(yuv[0].data(), yuv[1].data(), yuv[2].data(), xx, yy, outputSigned, actualRGB.data());
+			if (std::memcmp(expectedRGB.data(), actualRGB.data(), sizeof(expectedRGB)) != 0) mismatches++;
+
+			Array<U32, 4> expectedWords = {};
+			Array<U32, 4> actualWords = {};
+			SCALAR_KERNELS.Pack15Bit(&expectedRGB[(i % 32) * 8], outputSigned, expectedWords.data());
+			SSE2_KERNELS.Pack15Bit(&expectedRGB[(i % 32) * 8], outputSigned, actualWords.data());
+			if (expectedWords != actualWords) mismatches++;
+		}
+
+		//The recording is then decoded by both kernel sets in lockstep, every macroblock has to match word for word
+		SharedPtr<MDEC> reference = MakeShared<MDEC>();
+		SharedPtr<MDEC> candidate = MakeShared<MDEC>();
+		reference->mKernels = &SCALAR_KERNELS;
+		candidate->mKernels = &SSE2_KERNELS;
+
+		Array<U32, MAX_OUTPUT_WORDS> expected = {};
+		Array<U32, MAX_OUTPUT_WORDS> actual = {};
+		for (U32 value : stream) {
+			reference->setCommandOrParameters(value);
+			candidate->setCommandOrParameters(value);
+
+			while (reference->mDataOut.size() > 0 || candidate->mDataOut.size() > 0) {
+				U32 expectedCount = static_cast<U32>(reference->mDataOut.size());
+				U32 actualCount = static_cast<U32>(candidate->mDataOut.size());
+				if (expectedCount > 0) reference->channelOut(expected.data(), expectedCount);
+				if (actualCount > 0) candidate->channelOut(actual.data(), actualCount);
+
+				if (expectedCount != actualCount || !std::equal(expected.begin(), expected.begin() + expectedCount, actual.begin())) {
+					mismatches++;
 				}
 			}
-			if (mDecoding) {
-				copy_to_out();
-			} else {
-				mDataIn.clear();
-				mStatusRegister.DataInFIFOFull = ESX_FALSE;
+		}
+#endif
+
+		return mismatches;
+	}
+
+	void MDEC::pullMacroblock()
+	{
+		const MDECOutputBlock* block = &mOutputBlock;
+
+		if (mPipelineActive) {
+			//Only blocks when the worker has not caught up with the reader yet
+			U32 head = mPipelineHead.load(std::memory_order_relaxed);
+			while (mPipelineTail.load(std::memory_order_acquire) == head) {
+				std::this_thread::yield();
 			}
+			block = &mPipeline[head % PIPELINE_SIZE];
+		} else if (!decodeNext(mOutputBlock)) {
+			mOutputBlock.Last = ESX_TRUE;
 		}
 
+		if (block->Last) {
+			mDecoding = ESX_FALSE;
+		} else {
+			mDataOut.push_back(block->Words.data(), block->Size);
+		}
 		mStatusRegister.DataOutFIFOEmpty = mDataOut.size() == 0;
 
-		return word;
+		if (mPipelineActive) {
+			mConsumedSrc = block->SrcEnd;
+			mPipelineHead.store(mPipelineHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			mPipelineHead.notify_one();
+
+			if (!mDecoding) {
+				stopPipeline();
+			}
+		}
+	}
+
+	BIT MDEC::decodeNext(MDECOutputBlock& block)
+	{
+		BIT decoded = ESX_FALSE;
+
+		switch (mStatusRegister.DataOutputDepth) {
+			case MDECOutputDepth::Bit15:
+			case MDECOutputDepth::Bit24: {
+				decoded = decode_colored_macroblock();
+				break;
+			}
+
+			case MDECOutputDepth::Bit8:
+			case MDECOutputDepth::Bit4: {
+				decoded = decode_monochrome_macroblock();
+				break;
+			}
+		}
+
+		block.Size = 0;
+		block.Last = !decoded;
+		if (decoded) {
+			copy_to_out(block);
+		}
+		block.SrcEnd = mCurrentSrc;
+
+		return decoded;
+	}
+
+	void MDEC::startPipeline()
+	{
+		mPipelineHead = 0;
+		mPipelineTail = 0;
+		mConsumedSrc = mCurrentSrc;
+		mPipelineActive = ESX_TRUE;
+
+		mWorkerState = MDECWorkerState::Running;
+		mWorkerState.notify_one();
+	}
+
+	void MDEC::stopPipeline()
+	{
+		if (!mPipelineActive) return;
+
+		//Bumping the head wakes a worker parked on a full queue, both indices are reset on the next start
+		mCancelPipeline = ESX_TRUE;
+		mPipelineHead.fetch_add(1);
+		mPipelineHead.notify_one();
+
+		MDECWorkerState state;
+		while ((state = mWorkerState.load()) == MDECWorkerState::Running) {
+			mWorkerState.wait(state);
+		}
+		mCancelPipeline = ESX_FALSE;
+
+		//Anything decoded ahead but not read yet is dropped, decoding resumes lazily from the last block handed out
+		mCurrentSrc = mConsumedSrc;
+		mPipelineActive = ESX_FALSE;
+	}
+
+	void MDEC::workerLoop()
+	{
+		while (ESX_TRUE) {
+			mWorkerState.wait(MDECWorkerState::Idle);
+
+			MDECWorkerState state = mWorkerState.load();
+			if (state == MDECWorkerState::Quit) break;
+			if (state != MDECWorkerState::Running) continue;
+
+			BIT decoded = ESX_TRUE;
+			while (decoded) {
+				U32 tail = mPipelineTail.load(std::memory_order_relaxed);
+				U32 head = mPipelineHead.load();
+				if (mCancelPipeline.load()) break;
+				if (tail - head >= PIPELINE_SIZE) {
+					mPipelineHead.wait(head);
+					continue;
+				}
+
+				decoded = decodeNext(mPipeline[tail % PIPELINE_SIZE]);
+				mPipelineTail.store(tail + 1, std::memory_order_release);
+			}
+
+			mWorkerState = MDECWorkerState::Idle;
+			mWorkerState.notify_all();
+		}
 	}
 
 	U32 MDEC::getStatusRegister()
@@ -151,6 +739,9 @@ namespace esx {
 		mControlRegister.EnableDataOutRequest = (value >> 29) & 0x1;
 
 		if (mControlRegister.Reset) {
+			stopPipeline();
+			mDecoding = ESX_FALSE;
+
 			mCurrentCommand = MDECCommand::None;
 			setStatusRegister(0x80040000);
 			mDataIn.clear();
@@ -165,6 +756,9 @@ namespace esx {
 
 	void MDEC::setCommandOrParameters(U32 value)
 	{
+		//The worker reads mDataIn and the output format, hand decoding back to this thread first
+		stopPipeline();
+
 		if (mStatusRegister.NumberOfParameterWords == 0xFFFF || mCurrentCommand == MDECCommand::NoFunction || mCurrentCommand == MDECCommand::None) {
 			U8 command = (value >> 29) & 0x7;
 
@@ -203,7 +797,9 @@ namespace esx {
 			ESX_CORE_LOG_TRACE("MDEC - Command {} {}", command, mStatusRegister.NumberOfParameterWords);
 		} else {
 			//ESX_CORE_LOG_TRACE("MDEC - Parameter {:08x}h", value);
-			mDataIn.push_back(value);
+			if (!mDataIn.push_back(value)) {
+				ESX_CORE_LOG_WARNING("MDEC - Input FIFO overflow");
+			}
 
 			mStatusRegister.NumberOfParameterWords--;
 			if (mStatusRegister.NumberOfParameterWords == 0xFFFF) {
@@ -235,12 +831,12 @@ namespace esx {
 	void MDEC::setQuantTable()
 	{
 		for (I32 i = 0; i < 64; i++) {
-			mQuantTableLuminance[i] = reinterpret_cast<U8*>(mDataIn.data())[i];
+			mQuantTableLuminance[i] = reinterpret_cast<const U8*>(mDataIn.data())[i];
 		}
 
 		if (mDataIn.size() > 16) {
 			for (I32 i = 0; i < 64; i++) {
-				mQuantTableColor[i] = reinterpret_cast<U8*>(mDataIn.data())[64 + i];
+				mQuantTableColor[i] = reinterpret_cast<const U8*>(mDataIn.data())[64 + i];
 			}
 		}
 
@@ -251,7 +847,7 @@ namespace esx {
 	void MDEC::setScaleTable()
 	{
 		for (I32 i = 0; i < 64; i++) {
-			mScaleTable[i] = reinterpret_cast<I16*>(mDataIn.data())[i];
+			mScaleTable[i] = reinterpret_cast<const I16*>(mDataIn.data())[i];
 		}
 
 		mDataIn.clear();
@@ -263,26 +859,11 @@ namespace esx {
 		mCurrentSrc = 0;
 		mDecoding = ESX_TRUE;
 
-		switch (mStatusRegister.DataOutputDepth) {
-			case MDECOutputDepth::Bit15:
-			case MDECOutputDepth::Bit24: {
-				if (!decode_colored_macroblock()) {
-					mDecoding = ESX_FALSE;
-				}
-				break;
-			}
-
-			case MDECOutputDepth::Bit8:
-			case MDECOutputDepth::Bit4: {
-				if (!decode_monochrome_macroblock()) {
-					mDecoding = ESX_FALSE;
-				}
-				break;
-			}
-		}
-		if (mDecoding) {
-			copy_to_out();
+		if (mPipelined) {
+			startPipeline();
 		}
+
+		pullMacroblock();
 	}
 
 	constexpr Array<U8, 64> zigzag = {
@@ -370,7 +951,7 @@ namespace esx {
 			if (src >= (mDataIn.size() * 2)) {
 				return ESX_FALSE;
 			}
-			n = reinterpret_cast<U16*>(mDataIn.data())[src++];
+			n = reinterpret_cast<const U16*>(mDataIn.data())[src++];
 		} while (n == 0xFE00);
 
 		I32 q_scale = (n >> 10) & 0x3F;
@@ -394,7 +975,7 @@ namespace esx {
 				return ESX_FALSE;
 			}
 
-			n = reinterpret_cast<U16*>(mDataIn.data())[src];
+			n = reinterpret_cast<const U16*>(mDataIn.data())[src];
 			src++;
 
 			k += ((n >> 10) & 0x3F) + 1;
@@ -410,47 +991,9 @@ namespace esx {
 
 	void MDEC::fast_idct_core(Array<I16, 64>& blk)
 	{
-		Array<I16, 64> src = blk;
 		Array<I16, 64> dst = {};
-
-		for (I32 pass = 0; pass < 2; pass++) {
-			for (I32 i = 0; i < 8; i++) {
-				BIT isColumnZero = ESX_TRUE;
-				for (I32 k = 0; k < 8; k++) {
-					if (src[k * 8 + i] != 0) {
-						isColumnZero = ESX_FALSE;
-						break;
-					}
-				}
-
-				if (isColumnZero) {
-					for (I32 k = 0; k < 8; k++) {
-						dst[i * 8 + k] = src[0 * 8 + i];
-					}
-				}
-				else {
-					F32 z10 = src[0 * 8 + i] + src[4 * 8 + i]; F32 z11 = src[0 * 8 + i] - src[4 * 8 + i];
-					F32 z13 = src[2 * 8 + i] + src[6 * 8 + i]; F32 z12 = src[2 * 8 + i] - src[6 * 8 + i];
-					z12 = (1.414213562f * z12) - z13;
-
-					F32 tmp0 = z10 + z13; F32 tmp3 = z10 - z13; F32 tmp1 = z11 + z12; F32 tmp2 = z11 - z12;
-					z13 = src[3 * 8 + i] + src[5 * 8 + i]; z10 = src[3 * 8 + i] - src[5 * 8 + i];
-					z11 = src[1 * 8 + i] + src[7 * 8 + i]; z12 = src[1 * 8 + i] - src[7 * 8 + i];
-					F32 z5 = (1.847759065f * (z12 - z10));
-
-					F32 tmp7 = z11 + z13;
-					F32 tmp6 = (2.613125930f * (z10)) + z5 - tmp7;
-					F32 tmp5 = (1.414213562f * (z11 - z13)) - tmp6;
-					F32 tmp4 = (1.082392200f * (z12)) - z5 + tmp5;
-					dst[i * 8 + 0] = tmp0 + tmp7; dst[i * 8 + 7] = tmp0 - tmp7;
-					dst[i * 8 + 1] = tmp1 + tmp6; dst[i * 8 + 6] = tmp1 - tmp6;
-					dst[i * 8 + 2] = tmp2 + tmp5; dst[i * 8 + 5] = tmp2 - tmp5;
-					dst[i * 8 + 4] = tmp3 + tmp4; dst[i * 8 + 3] = tmp3 - tmp4;
-				}
-			}
-			std::swap(src, dst);
-		}
-		blk = src;
+		mKernels->IDCTPass(blk.data(), dst.data());
+		mKernels->IDCTPass(dst.data(), blk.data());
 	}
 
 	void MDEC::real_idct_core(Array<I16, 64>& blk)
@@ -476,37 +1019,9 @@ namespace esx {
 
 	void MDEC::yuv_to_rgb(const Array<I16, 64>& Crblk, const Array<I16, 64>& Cbblk, const Array<I16, 64>& Yblk, U64 xx, U64 yy)
 	{
-		for (I32 y = 0; y < 8; y++) {
-			for (I32 x = 0; x < 8; x++) {
-				U64 index = ((x + xx) / 2) + ((y + yy) / 2) * 8;
-				I16 R = Crblk[index];
-				I16 B = Cbblk[index];
-				I16 G = static_cast<I16>((-0.3437f * static_cast<F32>(B)) + (-0.7143f * static_cast<F32>(R)));
-
-				R = static_cast<I16>((1.402f * static_cast<F32>(R)));
-				B = static_cast<I16>((1.772f * static_cast<F32>(B)));
-
-				I16 Y = Yblk[x + y * 8];
-				R = std::clamp<I16>(Y + R, -128, 127);
-				G = std::clamp<I16>(Y + G, -128, 127);
-				B = std::clamp<I16>(Y + B, -128, 127);
-
-				U32 BGR = (static_cast<U8>(B & 0xFF) << 16) | (static_cast<U8>(G & 0xFF) << 8) | (static_cast<U8>(R & 0xFF) << 0);
-
-				if (mStatusRegister.DataOutputSigned == ESX_FALSE) {
-					R ^= 0x80;
-					G ^= 0x80;
-					B ^= 0x80;
-				}
-
-				mCurrentDecodedBlock[(x + xx) + (y + yy) * 16].R = R;
-				mCurrentDecodedBlock[(x + xx) + (y + yy) * 16].G = G;
-				mCurrentDecodedBlock[(x + xx) + (y + yy) * 16].B = B;
-			}
-		}
+		mKernels->YUVToRGB(Crblk.data(), Cbblk.data(), Yblk.data(), xx, yy, mStatusRegister.DataOutputSigned, mCurrentDecodedBlock.data());
 	}
 
-
 	void MDEC::y_to_mono(const Array<I16, 64>& Yblk)
 	{
 		for (I32 i = 0; i < 64; i++) {
@@ -522,7 +1037,7 @@ namespace esx {
 		}
 	}
 
-	void MDEC::copy_to_out()
+	void MDEC::copy_to_out(MDECOutputBlock& block)
 	{
 		switch (mStatusRegister.DataOutputDepth) {
 			case MDECOutputDepth::Bit24: {
@@ -531,12 +1046,12 @@ namespace esx {
 
 					if (mTidyPack24BitBytesToFill != 0) {
 						U32 bytesToAppend = (word & (0xFFFFFF >> ((3 - mTidyPack24BitBytesToFill) * 8))) << ((4 - mTidyPack24BitBytesToFill) * 8);
-						mDataOut.back() = mDataOut.back() | bytesToAppend;
+						block.Words[block.Size - 1] |= bytesToAppend;
 						word >>= (mTidyPack24BitBytesToFill * 8);
 					}
 
 					if (mTidyPack24BitBytesToFill != 3) {
-						mDataOut.emplace_back(word);
+						block.Words[block.Size++] = word;
 					}
 
 					mTidyPack24BitBytesToFill = (mTidyPack24BitBytesToFill + 1) % 4;
@@ -545,23 +1060,9 @@ namespace esx {
 			}
 			case MDECOutputDepth::Bit15: {
 				U16 a = mStatusRegister.DataOutputBit15Set;
-				for (I32 i = 0; i < mCurrentDecodedBlock.size();) {
-					MDECRGB& rgb1 = mCurrentDecodedBlock[i++];
-					U8 r = (rgb1.R >> 3) & 0x1F;
-					U8 g = (rgb1.G >> 3) & 0x1F;
-					U8 b = (rgb1.B >> 3) & 0x1F;
-					U16 pixel1 = (a << 15) | (b << 10) | (g << 5) | r;
-
-
-					MDECRGB& rgb2 = mCurrentDecodedBlock[i++];
-					r = (rgb2.R >> 3) & 0x1F;
-					g = (rgb2.G >> 3) & 0x1F;
-					b = (rgb2.B >> 3) & 0x1F;
-					U16 pixel2 = (a << 15) | (b << 10) | (g << 5) | r;
-
-					U32 packet = (U32(pixel2) << 16) | pixel1;
-
-					mDataOut.emplace_back(packet);
+				for (I32 i = 0; i < mCurrentDecodedBlock.size(); i += 8) {
+					mKernels->Pack15Bit(&mCurrentDecodedBlock[i], a, &block.Words[block.Size]);
+					block.Size += 4;
 				}
 				break;
 			}
@@ -576,7 +1077,7 @@ namespace esx {
 					packet |= (mCurrentDecodedBlock[i++].WORD >> 4) << 24;
 					packet |= (mCurrentDecodedBlock[i++].WORD >> 4) << 28;
 
-					mDataOut.emplace_back(packet);
+					block.Words[block.Size++] = packet;
 				}
 				break;
 			}
@@ -587,13 +1088,11 @@ namespace esx {
 					packet |= mCurrentDecodedBlock[i++].WORD << 16;
 					packet |= mCurrentDecodedBlock[i++].WORD << 24;
 
-					mDataOut.emplace_back(packet);
+					block.Words[block.Size++] = packet;
 				}
 				break;
 			}
 		}
-		
-		mStatusRegister.DataOutFIFOEmpty = mDataOut.size() == 0;
 	}
 
 
@@ -48,6 +48,30 @@ namespace esx {
 		};
 	};
 
+	enum class MDECWorkerState : U8 {
+		Idle,
+		Running,
+		Quit
+	};
+
+	struct MDECOutputBlock {
+		Array<U32, 192> Words = {};
+		U32 Size = 0;
+		U64 SrcEnd = 0;
+		BIT Last = ESX_FALSE;
+	};
+
+	struct MDECBenchmarkResult {
+		U64 Macroblocks = 0;
+		F64 Seconds = 0.0;
+		Array<U64, 4> DepthMacroblocks = {};
+		Array<U64, 4> DepthHashes = {};
+		BIT KernelsCompared = ESX_FALSE;
+		U64 KernelMismatches = 0;
+	};
+
+	struct MDECKernels;
+
 	class MDEC : public BusDevice {
 	public:
 		MDEC();
@@ -61,7 +85,23 @@ namespace esx {
 		virtual void reset() override;
 
 		void channelIn(U32 word);
+		void channelIn(const U32* input, U32 numWords);
 		U32 channelOut();
+		void channelOut(U32* output, U32 numWords);
+
+		void setPipelined(BIT pipelined);
+		BIT isPipelined() const { return mPipelined; }
+
+		void startRecording(const std::filesystem::path& path);
+		void stopRecording();
+		BIT isRecording() const { return mRecordStream.is_open(); }
+
+		static Optional<MDECBenchmarkResult> Benchmark(const std::filesystem::path& path, U32 iterations = 1, BIT pipelined = ESX_FALSE);
+
+		//Expected per-depth hashes live next to the recording, a new recording invalidates them
+		static std::filesystem::path GetBenchmarkHashPath(const std::filesystem::path& path);
+		static Optional<MDECBenchmarkResult> LoadBenchmarkHashes(const std::filesystem::path& path);
+		static BIT SaveBenchmarkHashes(const std::filesystem::path& path, const MDECBenchmarkResult& result);
 
 	private:
 		U32 getStatusRegister();
@@ -76,6 +116,12 @@ namespace esx {
 		void setQuantTable();
 		void setScaleTable();
 		void decodeMacroblock();
+		void pullMacroblock();
+		BIT decodeNext(MDECOutputBlock& block);
+
+		void startPipeline();
+		void stopPipeline();
+		void workerLoop();
 
 		BIT decode_colored_macroblock();
 		BIT decode_monochrome_macroblock();
@@ -85,14 +131,21 @@ namespace esx {
 		void yuv_to_rgb(const Array<I16, 64>& Crblk, const Array<I16, 64>& Cbblk, const Array<I16, 64>& Yblk, U64 xx, U64 yy);
 		void y_to_mono(const Array<I16, 64>& Yblk);
 
-		void copy_to_out();
+		void copy_to_out(MDECOutputBlock& block);
+
+		void record(const U32* words, U32 numWords);
+
+		static U64 CompareKernels(const Vector<U32>& stream);
 
 	private:
 		MDECStatusRegister mStatusRegister = {};
 		MDECControlRegister mControlRegister = {};
 		MDECCommand mCurrentCommand = MDECCommand::None;
-		Vector<U32> mDataIn = {};
-		Deque<U32> mDataOut = {};
+		//Sized for the longest parameter list and one macroblock of output
+		static constexpr U32 MAX_INPUT_WORDS = 0x10000;
+		static constexpr U32 MAX_OUTPUT_WORDS = 256;
+		RingBuffer<U32, MAX_INPUT_WORDS> mDataIn = {};
+		RingBuffer<U32, MAX_OUTPUT_WORDS> mDataOut = {};
 
 		Array<U8, 64> mQuantTableLuminance = {};
 		Array<U8, 64> mQuantTableColor = {};
@@ -102,6 +155,23 @@ namespace esx {
 		BIT mDecoding = ESX_FALSE;
 		U32 mTidyPack24BitBytesToFill = 0;
 		Array<MDECRGB, 256> mCurrentDecodedBlock = {};
+		const MDECKernels* mKernels = nullptr;
+		MDECOutputBlock mOutputBlock = {};
+
+		//Macroblocks decoded ahead by the worker, single producer single consumer
+		static constexpr U32 PIPELINE_SIZE = 16;
+		Array<MDECOutputBlock, PIPELINE_SIZE> mPipeline = {};
+		std::atomic<U32> mPipelineHead = 0;
+		std::atomic<U32> mPipelineTail = 0;
+		std::atomic<BIT> mCancelPipeline = ESX_FALSE;
+		std::atomic<MDECWorkerState> mWorkerState = MDECWorkerState::Idle;
+		std::thread mWorker;
+		BIT mPipelined = ESX_FALSE;
+		BIT mPipelineActive = ESX_FALSE;
+		U64 mConsumedSrc = 0;
+
+		//Every word written to the command/parameter port, replayed by Benchmark
+		std::ofstream mRecordStream;
 	};
 
 }
\ No newline at end of file
@@ -5,7 +5,80 @@
 
 #include "Core/Scheduler.h"
 
+#if defined(_M_X64) || defined(__SSE2__)
+	#define ESX_SPU_SSE2
+	#include <emmintrin.h>
+#endif
+
 namespace esx {
+
+	static constexpr Array<I16, 0x200> gauss = {
+		 -0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,
+		 -0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,
+		  0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0001,
+		  0x0001,0x0001,0x0001,0x0002,0x0002,0x0002,0x0003,0x0003,
+		  0x0003,0x0004,0x0004,0x0005,0x0005,0x0006,0x0007,0x0007,
+		  0x0008,0x0009,0x0009,0x000A,0x000B,0x000C,0x000D,0x000E,
+		  0x000F,0x0010,0x0011,0x0012,0x0013,0x0015,0x0016,0x0018,
+		  0x0019,0x001B,0x001C,0x001E,0x0020,0x0021,0x0023,0x0025,
+		  0x0027,0x0029,0x002C,0x002E,0x0030,0x0033,0x0035,0x0038,
+		  0x003A,0x003D,0x0040,0x0043,0x0046,0x0049,0x004D,0x0050,
+		  0x0054,0x0057,0x005B,0x005F,0x0063,0x0067,0x006B,0x006F,
+		  0x0074,0x0078,0x007D,0x0082,0x0087,0x008C,0x0091,0x0096,
+		  0x009C,0x00A1,0x00A7,0x00AD,0x00B3,0x00BA,0x00C0,0x00C7,
+		  0x00CD,0x00D4,0x00DB,0x00E3,0x00EA,0x00F2,0x00FA,0x0101,
+		  0x010A,0x0112,0x011B,0x0123,0x012C,0x0135,0x013F,0x0148,
+		  0x0152,0x015C,0x0166,0x0171,0x017B,0x0186,0x0191,0x019C,
+		  0x01A8,0x01B4,0x01C0,0x01CC,0x01D9,0x01E5,0x01F2,0x0200,
+		  0x020D,0x021B,0x0229,0x0237,0x0246,0x0255,0x0264,0x0273,
+		  0x0283,0x0293,0x02A3,0x02B4,0x02C4,0x02D6,0x02E7,0x02F9,
+		  0x030B,0x031D,0x0330,0x0343,0x0356,0x036A,0x037E,0x0392,
+		  0x03A7,0x03BC,0x03D1,0x03E7,0x03FC,0x0413,0x042A,0x0441,
+		  0x0458,0x0470,0x0488,0x04A0,0x04B9,0x04D2,0x04EC,0x0506,
+		  0x0520,0x053B,0x0556,0x0572,0x058E,0x05AA,0x05C7,0x05E4,
+		  0x0601,0x061F,0x063E,0x065C,0x067C,0x069B,0x06BB,0x06DC,
+		  0x06FD,0x071E,0x0740,0x0762,0x0784,0x07A7,0x07CB,0x07EF,
+		  0x0813,0x0838,0x085D,0x0883,0x08A9,0x08D0,0x08F7,0x091E,
+		  0x0946,0x096F,0x0998,0x09C1,0x09EB,0x0A16,0x0A40,0x0A6C,
+		  0x0A98,0x0AC4,0x0AF1,0x0B1E,0x0B4C,0x0B7A,0x0BA9,0x0BD8,
+		  0x0C07,0x0C38,0x0C68,0x0C99,0x0CCB,0x0CFD,0x0D30,0x0D63,
+		  0x0D97,0x0DCB,0x0E00,0x0E35,0x0E6B,0x0EA1,0x0ED7,0x0F0F,
+		  0x0F46,0x0F7F,0x0FB7,0x0FF1,0x102A,0x1065,0x109F,0x10DB,
+		  0x1116,0x1153,0x118F,0x11CD,0x120B,0x1249,0x1288,0x12C7,
+		  0x1307,0x1347,0x1388,0x13C9,0x140B,0x144D,0x1490,0x14D4,
+		  0x1517,0x155C,0x15A0,0x15E6,0x162C,0x1672,0x16B9,0x1700,
+		  0x1747,0x1790,0x17D8,0x1821,0x186B,0x18B5,0x1900,0x194B,
+		  0x1996,0x19E2,0x1A2E,0x1A7B,0x1AC8,0x1B16,0x1B64,0x1BB3,
+		  0x1C02,0x1C51,0x1CA1,0x1CF1,0x1D42,0x1D93,0x1DE5,0x1E37,
+		  0x1E89,0x1EDC,0x1F2F,0x1F82,0x1FD6,0x202A,0x207F,0x20D4,
+		  0x2129,0x217F,0x21D5,0x222C,0x2282,0x22DA,0x2331,0x2389,
+		  0x23E1,0x2439,0x2492,0x24EB,0x2545,0x259E,0x25F8,0x2653,
+		  0x26AD,0x2708,0x2763,0x27BE,0x281A,0x2876,0x28D2,0x292E,
+		  0x298B,0x29E7,0x2A44,0x2AA1,0x2AFF,0x2B5C,0x2BBA,0x2C18,
+		  0x2C76,0x2CD4,0x2D33,0x2D91,0x2DF0,0x2E4F,0x2EAE,0x2F0D,
+		  0x2F6C,0x2FCC,0x302B,0x308B,0x30EA,0x314A,0x31AA,0x3209,
+		  0x3269,0x32C9,0x3329,0x3389,0x33E9,0x3449,0x34A9,0x3509,
+		  0x3569,0x35C9,0x3629,0x3689,0x36E8,0x3748,0x37A8,0x3807,
+		  0x3867,0x38C6,0x3926,0x3985,0x39E4,0x3A43,0x3AA2,0x3B00,
+		  0x3B5F,0x3BBD,0x3C1B,0x3C79,0x3CD7,0x3D35,0x3D92,0x3DEF,
+		  0x3E4C,0x3EA9,0x3F05,0x3F62,0x3FBD,0x4019,0x4074,0x40D0,
+		  0x412A,0x4185,0x41DF,0x4239,0x4292,0x42EB,0x4344,0x439C,
+		  0x43F4,0x444C,0x44A3,0x44FA,0x4550,0x45A6,0x45FC,0x4651,
+		  0x46A6,0x46FA,0x474E,0x47A1,0x47F4,0x4846,0x4898,0x48E9,
+		  0x493A,0x498A,0x49D9,0x4A29,0x4A77,0x4AC5,0x4B13,0x4B5F,
+		  0x4BAC,0x4BF7,0x4C42,0x4C8D,0x4CD7,0x4D20,0x4D68,0x4DB0,
+		  0x4DF7,0x4E3E,0x4E84,0x4EC9,0x4F0E,0x4F52,0x4F95,0x4FD7,
+		  0x5019,0x505A,0x509A,0x50DA,0x5118,0x5156,0x5194,0x51D0,
+		  0x520C,0x5247,0x5281,0x52BA,0x52F3,0x532A,0x5361,0x5397,
+		  0x53CC,0x5401,0x5434,0x5467,0x5499,0x54CA,0x54FA,0x5529,
+		  0x5558,0x5585,0x55B2,0x55DE,0x5609,0x5632,0x565B,0x5684,
+		  0x56AB,0x56D1,0x56F6,0x571B,0x573E,0x5761,0x5782,0x57A3,
+		  0x57C3,0x57E2,0x57FF,0x581C,0x5838,0x5853,0x586D,0x5886,
+		  0x589E,0x58B5,0x58CB,0x58E0,0x58F4,0x5907,0x5919,0x592A,
+		  0x593A,0x5949,0x5958,0x5965,0x5971,0x597C,0x5986,0x598F,
+		  0x5997,0x599E,0x59A4,0x59A9,0x59AD,0x59B0,0x59B2,0x59B3
+	};
+
 	
 	static U16 getVolume(const Volume& volume)
 	{
@@ -133,7 +206,20 @@ namespace esx {
 	}
 
 
-	static Array<std::ofstream, 24> sStreams;
+	static constexpr Array<I16, 39> fir_filter_coefficients = {
+		 -0x0001,  0x0000,  0x0002,  0x0000, -0x000A,  0x0000,  0x0023,  0x0000,
+		 -0x0067,  0x0000,  0x010A,  0x0000, -0x0268,  0x0000,  0x0534,  0x0000,
+		 -0x0B90,  0x0000,  0x2806,  0x4000,  0x2806,  0x0000, -0x0B90,  0x0000,
+		  0x0534,  0x0000, -0x0268,  0x0000,  0x010A,  0x0000, -0x0067,  0x0000,
+		  0x0023,  0x0000, -0x000A,  0x0000,  0x0002,  0x0000, -0x0001,
+	};
+
+	//The filter is only ever applied to a single sample, so the kernel reduces exactly to its DC gain
+	static constexpr I32 fir_filter_gain = [] {
+		I32 gain = 0;
+		for (I16 coefficient : fir_filter_coefficients) gain += coefficient;
+		return gain;
+	}();
 
 	SPU::SPU()
 		: BusDevice(ESX_TEXT("SPU"))
@@ -141,7 +227,14 @@ namespace esx {
 		addRange(ESX_TEXT("Root"), 0x1F801C00, BYTE(640), 0xFFFFFFFF);
 
 		Scheduler::AddSchedulerEventHandler(SchedulerEventType::SPUSample, [&](const SchedulerEvent& ev) {
-			sampleClock(ev.ClockTarget);
+			if (!mSampling) return;
+			renderSamples(ev.ClockTarget);
+			scheduleSampleEvent(ESX_FALSE);
+		});
+
+		//Flush the pending samples once per frame so the audio ring never starves between register accesses
+		Scheduler::AddSchedulerEventHandler(SchedulerEventType::GPUStartVBlank, [&](const SchedulerEvent& ev) {
+			syncSamples();
 		});
 
 		reset();
@@ -149,7 +242,6 @@ namespace esx {
 
 	SPU::~SPU()
 	{
-		sStreams[0].close();
 	}
 	
 	void SPU::sampleClock(U64 clocks)
@@ -174,7 +266,16 @@ namespace esx {
 			I32 leftSum = 0, rightSum = 0;
 			I32 reverbLeftSum = 0, reverbRightSum = 0;
 
-			for (Voice& voice : mVoices) {
+			//Idle voices have zeroed lanes and only need the IRQ address check
+			for (U32 idle = ~mLiveVoices & 0xFFFFFF; idle != 0; idle &= idle - 1) {
+				if (mVoices[std::countr_zero(idle)].ADPCMCurrentAddress == mSoundRAMIRQAddress) {
+					getBus("Root")->getDevice<InterruptControl>("InterruptControl")->requestInterrupt(InterruptType::SPU, ESX_FALSE, ESX_TRUE);
+				}
+			}
+
+			//Voices are gathered into lanes, interpolated together, advanced in order and then mixed together
+			for (U32 live = mLiveVoices; live != 0; live &= live - 1) {
+				Voice& voice = mVoices[std::countr_zero(live)];
 				if (voice.KeyOff) {
 					voice.ADSR.Phase = ADSRPhaseType::Release;
 					voice.KeyOff = ESX_FALSE;
@@ -189,18 +290,52 @@ namespace esx {
 					getBus("Root")->getDevice<InterruptControl>("InterruptControl")->requestInterrupt(InterruptType::SPU, ESX_FALSE, ESX_TRUE);
 				}
 
-				auto [left, right] = sampleVoice(voice);
+				mLanes.Active[voice.Number] = prepareVoice(voice);
+			}
+
+			interpolateVoices();
+
+			for (U32 live = mLiveVoices; live != 0; live &= live - 1) {
+				Voice& voice = mVoices[std::countr_zero(live)];
+				U32 lane = voice.Number;
+				voice.Latest = mLanes.Latest[lane];
 
-				//Mixing
-				leftSum += (left * processVolume(voice.VolumeLeft)) >> 15;
-				rightSum += (right * processVolume(voice.VolumeRight)) >> 15;
+				mLanes.VoiceLeft[lane] = 0;
+				mLanes.VoiceRight[lane] = 0;
+				if (mLanes.Active[lane]) {
+					advanceVoice(voice);
 
+					mLanes.VoiceLeft[lane] = processVolume(voice.VolumeLeft);
+					mLanes.VoiceRight[lane] = processVolume(voice.VolumeRight);
+				}
+
+				//Sweeps tick on every call so the mixer keeps calling processVolume once per use
+				mLanes.MixLeft[lane] = processVolume(voice.VolumeLeft);
+				mLanes.MixRight[lane] = processVolume(voice.VolumeRight);
+
+				mLanes.ReverbLeft[lane] = 0;
+				mLanes.ReverbRight[lane] = 0;
 				if (voice.ReverbMode == ReverbMode::ToMixerAndToReverb) {
-					reverbLeftSum += (left * processVolume(voice.VolumeLeft)) >> 15;
-					reverbRightSum += (right * processVolume(voice.VolumeRight)) >> 15;
+					mLanes.ReverbLeft[lane] = processVolume(voice.VolumeLeft);
+					mLanes.ReverbRight[lane] = processVolume(voice.VolumeRight);
+				}
+
+				//A voice that just stopped stays live for one more sample so Latest settles to 0
+				if (!isVoiceLive(voice)) {
+					mLiveVoices &= ~(1 << lane);
+					mLanes.Envelope[lane] = 0;
+					mLanes.VoiceLeft[lane] = 0;
+					mLanes.VoiceRight[lane] = 0;
 				}
 			}
 
+			mixVoices(leftSum, rightSum, reverbLeftSum, reverbRightSum);
+
+			if (mVoiceCapture.isActive()) {
+				U32 lane = mCaptureVoice;
+				mVoiceCapture.push(AudioFrame(static_cast<I16>((mLanes.Latest[lane] * mLanes.VoiceLeft[lane]) >> 15), static_cast<I16>((mLanes.Latest[lane] * mLanes.VoiceRight[lane]) >> 15)));
+			}
+
 			if (!mSPUControl.Unmute) {
 				leftSum = 0;
 				rightSum = 0;
@@ -215,6 +350,7 @@ namespace esx {
 			}
 
 			AudioFrame cdFrame = mCDROM->HasAudioFramesAvailable() ? mCDROM->GetAudioFrame() : AudioFrame();
+			if (mCDCapture.isActive()) mCDCapture.push(cdFrame);
 			if (mSPUControl.CDAudioEnable && mCDROM->HasAudioFramesAvailable()) {
 				I16 left = (I32(cdFrame.Left) * I32(mCDInputVolume.Left)) >> 15;
 				I16 right = (I32(cdFrame.Right) * I32(mCDInputVolume.Right)) >> 15;
@@ -243,24 +379,79 @@ namespace esx {
 			I16 left = static_cast<I16>((SATURATE(leftSum) * processVolume(mMainVolumeLeft)) >> 15);
 			I16 right = static_cast<I16>((SATURATE(rightSum) * processVolume(mMainVolumeRight)) >> 15);
 
+			//Captures only queue the frame, the file is written on their own thread
+			if (mMixCapture.isActive()) mMixCapture.push(AudioFrame(left, right));
 
-			/*sStreams[0].write((char*)&left, 2);
-			sStreams[0].write((char*)&right, 2);*/
+			//A full ring means emulation is running ahead of the device, the frame is dropped
+			mTimeStretch.push(AudioFrame(left, right), mAudioRing);
+		}
+	}
+
+	void SPU::renderSamples(U64 targetClock)
+	{
+		while (mNextSampleClock <= targetClock) {
+			sampleClock(mNextSampleClock);
+			mNextSampleClock += CLOCKS_PER_SAMPLE;
+		}
+	}
+
+	void SPU::syncSamples()
+	{
+		if (mSampling) renderSamples(mCPU->getClocks());
+	}
+
+	U32 SPU::samplesUntilPossibleIRQ() const
+	{
+		U32 samples = MAX_BATCH_SAMPLES;
+		if (!mSPUControl.Enable) return samples;
 
-			AudioFrame& sample = mBackBuffer.Batch[mBackBuffer.CurrentFrame];
-			sample.Left = left;
-			sample.Right = right;
-			mBackBuffer.CurrentFrame++;
-			if (mBackBuffer.Complete()) {
-				std::scoped_lock<std::mutex> lc(mSamplesMutex);
-				std::swap(mFrontBuffer, mBackBuffer);
-				mBackBuffer = {};
+		//Voice addresses are compared every sample and only move on a key on or a block change
+		for (const Voice& voice : mVoices) {
+			if (voice.KeyOn || voice.ADPCMCurrentAddress == mSoundRAMIRQAddress) return 0;
+
+			if (voice.ADSR.Phase != ADSRPhaseType::Off) {
+				U32 remaining = (28 << 12) - std::min<U32>(voice.PitchCounter, 28 << 12);
+				samples = std::min<U32>(samples, std::max<U32>((remaining + 0x3FFE) / 0x3FFF, 1));
 			}
 		}
+
+		if (!mSPUControl.IRQ9Enable || mSPUStatus.IRQ9Flag) return samples;
+
+		if (mSPUControl.TransferMode == TransferMode::ManualWrite && !mFIFO.empty()) return 0;
+
+		//The four capture buffers are written in lockstep, two bytes per sample
+		U32 irqAddress = mSoundRAMIRQAddress * 8;
+		if (irqAddress < 0x1000) {
+			U32 block = irqAddress & 0x3F8;
+			if (((mCaptureBufferPointer - block) & 0x3FF) < 8) return 0;
+			samples = std::min<U32>(samples, ((block - mCaptureBufferPointer) & 0x3FF) / 2);
+		}
+
+		//Reverb touches its whole work area, every other sample
+		if (irqAddress >= ((U32)mReverb[mBASE] << 3)) {
+			samples = std::min<U32>(samples, (mNextSampleClock % 1536 == 0) ? 0 : 1);
+		}
+
+		return samples;
+	}
+
+	void SPU::scheduleSampleEvent(BIT unschedule)
+	{
+		if (unschedule) Scheduler::UnScheduleAllEvents(SchedulerEventType::SPUSample);
+		if (!mSampling) return;
+
+		SchedulerEvent spuSample = {
+			.Type = SchedulerEventType::SPUSample,
+			.ClockStart = mCPU->getClocks(),
+			.ClockTarget = mNextSampleClock + samplesUntilPossibleIRQ() * CLOCKS_PER_SAMPLE
+		};
+		Scheduler::ScheduleEvent(spuSample);
 	}
 
 	void SPU::store(const StringView& busName, U32 address, U16 value)
 	{
+		syncSamples();
+
 		if (address < 0x1F801D80) {
 			U32 voice = (address >> 4) & 0x3F;
 			U32 registerAddress = address & ~0x3F0;
@@ -436,10 +627,14 @@ namespace esx {
 		} else {
 			ESX_CORE_LOG_ERROR("SPU - Writing to address {:08x} not implemented yet", address);
 		}
+
+		scheduleSampleEvent();
 	}
 
 	void SPU::load(const StringView& busName, U32 address, U16& output)
 	{
+		syncSamples();
+
 		if (address < 0x1F801D80) {
 			U32 voice = (address >> 4) & 0x3F;
 			U32 registerAddress = address & ~0x3F0;
@@ -646,6 +841,8 @@ namespace esx {
 	void SPU::reset()
 	{
 		mVoices = {};
+		mLanes = {};
+		mLiveVoices = 0;
 		mMainVolumeLeft = {};
 		mMainVolumeRight = {};
 		mCurrentMainVolume = {};
@@ -662,30 +859,53 @@ namespace esx {
 		mNoiseLevel = 0;
 
 		mReverb = {};
+		mReverbTaps = {};
 		mCurrentBufferAddress = 0x00000000;
 
 		mFIFO = {};
 
 		mCurrentTransferAddress = 0;
 
-		std::scoped_lock lc(mSamplesMutex);
-		mBackBuffer = {};
-		mFrontBuffer = {};
+		mSampling = ESX_FALSE;
+		mNextSampleClock = 0;
+		mAudioRing.requestFlush();
 
 		mRAM.resize(KIBI(512));
 		std::fill(mRAM.begin(),mRAM.end(),0x00);
+		invalidateADPCMCache(0, (U32)mRAM.size());
 		for (U32 i = 0; i < 24; i++) {
 			mVoices[i].Number = i;
-			if(i==0 && !sStreams[i].is_open()) sStreams[i].open(std::to_string(i) + ".bin", std::ios::binary);
 		}
 	}
 
 	Pair<I16, I16> SPU::reverb(I16 LeftInput, I16 RightInput)
+	{
+		if (mReverbTaps.Dirty) updateReverbTaps();
+
+		//IRQ checks and a buffer address left below a raised mBASE take the original per access path
+		mReverbTaps.Checked = (mSPUControl.IRQ9Enable && !mSPUStatus.IRQ9Flag) || mCurrentBufferAddress < mReverbTaps.Base;
+		mReverbTaps.Position = mCurrentBufferAddress - mReverbTaps.Base;
+
+		Pair<I16, I16> output = {};
+#ifdef ESX_SPU_SSE2
+		if (!mReverbTaps.Checked && !mReverbTaps.Aliased) {
+			output = reverbSSE2(LeftInput, RightInput);
+		} else {
+			output = reverbScalar(LeftInput, RightInput);
+		}
+#else
+		output = reverbScalar(LeftInput, RightInput);
+#endif
+
+		mCurrentBufferAddress = std::max(((U32)mReverb[mBASE]) << 3, (mCurrentBufferAddress + 2) & 0x7FFFE);
+
+		return output;
+	}
+
+	Pair<I16, I16> SPU::reverbScalar(I16 LeftInput, I16 RightInput)
 	{
 		#define MULT(x,y) (((x) * (y)) >> 15)
-		#define LOAD(x) loadReverb(mReverb[x])
-		#define LOAD_DIFF(x,y) loadReverb(mReverb[x] - mReverb[y])
-		#define LOAD_SUB(x,y) loadReverb(mReverb[x] - y)
+		#define LOAD(x) loadReverbTap(x)
 		#define VOLUME(x) (I16)mReverb[x]
 
 		LeftInput = reverbFirFilter(LeftInput);
@@ -695,40 +915,40 @@ namespace esx {
 		I16 Rin = MULT(VOLUME(vRIN), RightInput);
 
 		//____Same Side Reflection (left-to-left and right-to-right)___________________
-		I16 mlSame = SATURATE(MULT(Lin + MULT(LOAD(dLSAME), VOLUME(vWALL)) - LOAD_SUB(mLSAME, 2), VOLUME(vIIR)) + LOAD_SUB(mLSAME, 2));
-		I16 mrSame = SATURATE(MULT(Rin + MULT(LOAD(dRSAME), VOLUME(vWALL)) - LOAD_SUB(mRSAME, 2), VOLUME(vIIR)) + LOAD_SUB(mRSAME, 2));
-		writeReverb(mLSAME, mlSame);
-		writeReverb(mRSAME, mrSame);
+		I16 mlSame = SATURATE(MULT(Lin + MULT(LOAD(TapLSameDelay), VOLUME(vWALL)) - LOAD(TapLSamePrevious), VOLUME(vIIR)) + LOAD(TapLSamePrevious));
+		I16 mrSame = SATURATE(MULT(Rin + MULT(LOAD(TapRSameDelay), VOLUME(vWALL)) - LOAD(TapRSamePrevious), VOLUME(vIIR)) + LOAD(TapRSamePrevious));
+		writeReverbTap(TapLSame, mlSame);
+		writeReverbTap(TapRSame, mrSame);
 
 		//___Different Side Reflection (left-to-right and right-to-left)_______________
-		I16 mlDiff = SATURATE(MULT(Lin + MULT(LOAD(dRDIFF), VOLUME(vWALL)) - LOAD_SUB(mLDIFF, 2), VOLUME(vIIR)) + LOAD_SUB(mLDIFF, 2));
-		I16 mrDiff = SATURATE(MULT(Rin + MULT(LOAD(dLDIFF), VOLUME(vWALL)) - LOAD_SUB(mRDIFF, 2), VOLUME(vIIR)) + LOAD_SUB(mRDIFF, 2));
-		writeReverb(mLDIFF, mlDiff);
-		writeReverb(mRDIFF, mrDiff);
+		I16 mlDiff = SATURATE(MULT(Lin + MULT(LOAD(TapRDiffDelay), VOLUME(vWALL)) - LOAD(TapLDiffPrevious), VOLUME(vIIR)) + LOAD(TapLDiffPrevious));
+		I16 mrDiff = SATURATE(MULT(Rin + MULT(LOAD(TapLDiffDelay), VOLUME(vWALL)) - LOAD(TapRDiffPrevious), VOLUME(vIIR)) + LOAD(TapRDiffPrevious));
+		writeReverbTap(TapLDiff, mlDiff);
+		writeReverbTap(TapRDiff, mrDiff);
 
 		//Early echo
-		I16 Lout = SATURATE(MULT(VOLUME(vCOMB1), LOAD(mLCOMB1)) + MULT(VOLUME(vCOMB2), LOAD(mLCOMB2)) + MULT(VOLUME(vCOMB3), LOAD(mLCOMB3)) + MULT(VOLUME(vCOMB4), LOAD(mLCOMB4)));
-		I16 Rout = SATURATE(MULT(VOLUME(vCOMB1), LOAD(mRCOMB1)) + MULT(VOLUME(vCOMB2), LOAD(mRCOMB2)) + MULT(VOLUME(vCOMB3), LOAD(mRCOMB3)) + MULT(VOLUME(vCOMB4), LOAD(mRCOMB4)));
+		I16 Lout = SATURATE(MULT(VOLUME(vCOMB1), LOAD(TapLComb1)) + MULT(VOLUME(vCOMB2), LOAD(TapLComb2)) + MULT(VOLUME(vCOMB3), LOAD(TapLComb3)) + MULT(VOLUME(vCOMB4), LOAD(TapLComb4)));
+		I16 Rout = SATURATE(MULT(VOLUME(vCOMB1), LOAD(TapRComb1)) + MULT(VOLUME(vCOMB2), LOAD(TapRComb2)) + MULT(VOLUME(vCOMB3), LOAD(TapRComb3)) + MULT(VOLUME(vCOMB4), LOAD(TapRComb4)));
 
 		// Late reverb APF1
-		Lout = SATURATE(Lout - MULT(VOLUME(vAPF1), LOAD_DIFF(mLAPF1, dAPF1)));
-		Rout = SATURATE(Rout - MULT(VOLUME(vAPF1), LOAD_DIFF(mRAPF1, dAPF1)));
+		Lout = SATURATE(Lout - MULT(VOLUME(vAPF1), LOAD(TapLAPF1Delay)));
+		Rout = SATURATE(Rout - MULT(VOLUME(vAPF1), LOAD(TapRAPF1Delay)));
 
-		writeReverb(mReverb[mLAPF1], Lout); 
-		writeReverb(mReverb[mRAPF1], Rout);
+		writeReverbTap(TapLAPF1, Lout);
+		writeReverbTap(TapRAPF1, Rout);
 
-		Lout = SATURATE(MULT(Lout, VOLUME(vAPF1)) + LOAD_DIFF(mLAPF1, dAPF1));
-		Rout = SATURATE(MULT(Rout, VOLUME(vAPF1)) + LOAD_DIFF(mRAPF1, dAPF1));
+		Lout = SATURATE(MULT(Lout, VOLUME(vAPF1)) + LOAD(TapLAPF1Delay));
+		Rout = SATURATE(MULT(Rout, VOLUME(vAPF1)) + LOAD(TapRAPF1Delay));
 
 		// Late reverb APF2
-		Lout = SATURATE(Lout - MULT(VOLUME(vAPF2), LOAD_DIFF(mLAPF2, dAPF2)));
-		Rout = SATURATE(Rout - MULT(VOLUME(vAPF2), LOAD_DIFF(mRAPF2, dAPF2)));
+		Lout = SATURATE(Lout - MULT(VOLUME(vAPF2), LOAD(TapLAPF2Delay)));
+		Rout = SATURATE(Rout - MULT(VOLUME(vAPF2), LOAD(TapRAPF2Delay)));
 
-		writeReverb(mReverb[mLAPF2], Lout);
-		writeReverb(mReverb[mRAPF2], Rout);
+		writeReverbTap(TapLAPF2, Lout);
+		writeReverbTap(TapRAPF2, Rout);
 
-		Lout = SATURATE(MULT(Lout, VOLUME(vAPF2)) + LOAD_DIFF(mLAPF2, dAPF2));
-		Rout = SATURATE(MULT(Rout, VOLUME(vAPF2)) + LOAD_DIFF(mRAPF2, dAPF2));
+		Lout = SATURATE(MULT(Lout, VOLUME(vAPF2)) + LOAD(TapLAPF2Delay));
+		Rout = SATURATE(MULT(Rout, VOLUME(vAPF2)) + LOAD(TapRAPF2Delay));
 
 		//___Output to Mixer (Output volume multiplied with input from APF2)___________
 		I16 LeftOutput = SATURATE(MULT(Lout, VOLUME(vLOUT)));
@@ -737,83 +957,73 @@ namespace esx {
 		LeftOutput = reverbFirFilter(LeftOutput);
 		RightOutput = reverbFirFilter(RightOutput);
 
-		mCurrentBufferAddress = std::max(((U32)mReverb[mBASE]) << 3, (mCurrentBufferAddress + 2) & 0x7FFFE);
-
 		return std::make_pair(LeftOutput, RightOutput);
 	}
 
-	Pair<I32, I32> SPU::sampleVoice(Voice& voice)
-	{
-		static constexpr Array<I32, 0x200> gauss = {
-			 -0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,
-			 -0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,-0x0001,
-			  0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0001,
-			  0x0001,0x0001,0x0001,0x0002,0x0002,0x0002,0x0003,0x0003,
-			  0x0003,0x0004,0x0004,0x0005,0x0005,0x0006,0x0007,0x0007,
-			  0x0008,0x0009,0x0009,0x000A,0x000B,0x000C,0x000D,0x000E,
-			  0x000F,0x0010,0x0011,0x0012,0x0013,0x0015,0x0016,0x0018,
-			  0x0019,0x001B,0x001C,0x001E,0x0020,0x0021,0x0023,0x0025,
-			  0x0027,0x0029,0x002C,0x002E,0x0030,0x0033,0x0035,0x0038,
-			  0x003A,0x003D,0x0040,0x0043,0x0046,0x0049,0x004D,0x0050,
-			  0x0054,0x0057,0x005B,0x005F,0x0063,0x0067,0x006B,0x006F,
-			  0x0074,0x0078,0x007D,0x0082,0x0087,0x008C,0x0091,0x0096,
-			  0x009C,0x00A1,0x00A7,0x00AD,0x00B3,0x00BA,0x00C0,0x00C7,
-			  0x00CD,0x00D4,0x00DB,0x00E3,0x00EA,0x00F2,0x00FA,0x0101,
-			  0x010A,0x0112,0x011B,0x0123,0x012C,0x0135,0x013F,0x0148,
-			  0x0152,0x015C,0x0166,0x0171,0x017B,0x0186,0x0191,0x019C,
-			  0x01A8,0x01B4,0x01C0,0x01CC,0x01D9,0x01E5,0x01F2,0x0200,
-			  0x020D,0x021B,0x0229,0x0237,0x0246,0x0255,0x0264,0x0273,
-			  0x0283,0x0293,0x02A3,0x02B4,0x02C4,0x02D6,0x02E7,0x02F9,
-			  0x030B,0x031D,0x0330,0x0343,0x0356,0x036A,0x037E,0x0392,
-			  0x03A7,0x03BC,0x03D1,0x03E7,0x03FC,0x0413,0x042A,0x0441,
-			  0x0458,0x0470,0x0488,0x04A0,0x04B9,0x04D2,0x04EC,0x0506,
-			  0x0520,0x053B,0x0556,0x0572,0x058E,0x05AA,0x05C7,0x05E4,
-			  0x0601,0x061F,0x063E,0x065C,0x067C,0x069B,0x06BB,0x06DC,
-			  0x06FD,0x071E,0x0740,0x0762,0x0784,0x07A7,0x07CB,0x07EF,
-			  0x0813,0x0838,0x085D,0x0883,0x08A9,0x08D0,0x08F7,0x091E,
-			  0x0946,0x096F,0x0998,0x09C1,0x09EB,0x0A16,0x0A40,0x0A6C,
-			  0x0A98,0x0AC4,0x0AF1,0x0B1E,0x0B4C,0x0B7A,0x0BA9,0x0BD8,
-			  0x0C07,0x0C38,0x0C68,0x0C99,0x0CCB,0x0CFD,0x0D30,0x0D63,
-			  0x0D97,0x0DCB,0x0E00,0x0E35,0x0E6B,0x0EA1,0x0ED7,0x0F0F,
-			  0x0F46,0x0F7F,0x0FB7,0x0FF1,0x102A,0x1065,0x109F,0x10DB,
-			  0x1116,0x1153,0x118F,0x11CD,0x120B,0x1249,0x1288,0x12C7,
-			  0x1307,0x1347,0x1388,0x13C9,0x140B,0x144D,0x1490,0x14D4,
-			  0x1517,0x155C,0x15A0,0x15E6,0x162C,0x1672,0x16B9,0x1700,
-			  0x1747,0x1790,0x17D8,0x1821,0x186B,0x18B5,0x1900,0x194B,
-			  0x1996,0x19E2,0x1A2E,0x1A7B,0x1AC8,0x1B16,0x1B64,0x1BB3,
-			  0x1C02,0x1C51,0x1CA1,0x1CF1,0x1D42,0x1D93,0x1DE5,0x1E37,
-			  0x1E89,0x1EDC,0x1F2F,0x1F82,0x1FD6,0x202A,0x207F,0x20D4,
-			  0x2129,0x217F,0x21D5,0x222C,0x2282,0x22DA,0x2331,0x2389,
-			  0x23E1,0x2439,0x2492,0x24EB,0x2545,0x259E,0x25F8,0x2653,
-			  0x26AD,0x2708,0x2763,0x27BE,0x281A,0x2876,0x28D2,0x292E,
-			  0x298B,0x29E7,0x2A44,0x2AA1,0x2AFF,0x2B5C,0x2BBA,0x2C18,
-			  0x2C76,0x2CD4,0x2D33,0x2D91,0x2DF0,0x2E4F,0x2EAE,0x2F0D,
-			  0x2F6C,0x2FCC,0x302B,0x308B,0x30EA,0x314A,0x31AA,0x3209,
-			  0x3269,0x32C9,0x3329,0x3389,0x33E9,0x3449,0x34A9,0x3509,
-			  0x3569,0x35C9,0x3629,0x3689,0x36E8,0x3748,0x37A8,0x3807,
-			  0x3867,0x38C6,0x3926,0x3985,0x39E4,0x3A43,0x3AA2,0x3B00,
-			  0x3B5F,0x3BBD,0x3C1B,0x3C79,0x3CD7,0x3D35,0x3D92,0x3DEF,
-			  0x3E4C,0x3EA9,0x3F05,0x3F62,0x3FBD,0x4019,0x4074,0x40D0,
-			  0x412A,0x4185,0x41DF,0x4239,0x4292,0x42EB,0x4344,0x439C,
-			  0x43F4,0x444C,0x44A3,0x44FA,0x4550,0x45A6,0x45FC,0x4651,
-			  0x46A6,0x46FA,0x474E,0x47A1,0x47F4,0x4846,0x4898,0x48E9,
-			  0x493A,0x498A,0x49D9,0x4A29,0x4A77,0x4AC5,0x4B13,0x4B5F,
-			  0x4BAC,0x4BF7,0x4C42,0x4C8D,0x4CD7,0x4D20,0x4D68,0x4DB0,
-			  0x4DF7,0x4E3E,0x4E84,0x4EC9,0x4F0E,0x4F52,0x4F95,0x4FD7,
-			  0x5019,0x505A,0x509A,0x50DA,0x5118,0x5156,0x5194,0x51D0,
-			  0x520C,0x5247,0x5281,0x52BA,0x52F3,0x532A,0x5361,0x5397,
-			  0x53CC,0x5401,0x5434,0x5467,0x5499,0x54CA,0x54FA,0x5529,
-			  0x5558,0x5585,0x55B2,0x55DE,0x5609,0x5632,0x565B,0x5684,
-			  0x56AB,0x56D1,0x56F6,0x571B,0x573E,0x5761,0x5782,0x57A3,
-			  0x57C3,0x57E2,0x57FF,0x581C,0x5838,0x5853,0x586D,0x5886,
-			  0x589E,0x58B5,0x58CB,0x58E0,0x58F4,0x5907,0x5919,0x592A,
-			  0x593A,0x5949,0x5958,0x5965,0x5971,0x597C,0x5986,0x598F,
-			  0x5997,0x599E,0x59A4,0x59A9,0x59AD,0x59B0,0x59B2,0x59B3
+	void SPU::updateReverbTaps()
+	{
+		ReverbTaps& taps = mReverbTaps;
+
+		//The same and different side writes go to the register indices themselves, as they always did
+		taps.Addresses = {
+			mReverb[dLSAME], mReverb[dRSAME], U16(mReverb[mLSAME] - 2), U16(mReverb[mRSAME] - 2), U16(mLSAME), U16(mRSAME),
+			mReverb[dRDIFF], mReverb[dLDIFF], U16(mReverb[mLDIFF] - 2), U16(mReverb[mRDIFF] - 2), U16(mLDIFF), U16(mRDIFF),
+			mReverb[mLCOMB1], mReverb[mLCOMB2], mReverb[mLCOMB3], mReverb[mLCOMB4],
+			mReverb[mRCOMB1], mReverb[mRCOMB2], mReverb[mRCOMB3], mReverb[mRCOMB4],
+			U16(mReverb[mLAPF1] - mReverb[dAPF1]), U16(mReverb[mRAPF1] - mReverb[dAPF1]), mReverb[mLAPF1], mReverb[mRAPF1],
+			U16(mReverb[mLAPF2] - mReverb[dAPF2]), U16(mReverb[mRAPF2] - mReverb[dAPF2]), mReverb[mLAPF2], mReverb[mRAPF2]
 		};
 
+		taps.Base = ((U32)mReverb[mBASE]) << 3;
+		taps.Size = 0x80000 - taps.Base;
+		for (U32 tap = 0; tap < TapCount; tap++) {
+			taps.Offsets[tap] = (((U32)taps.Addresses[tap]) << 3) % taps.Size;
+		}
+
+		//The vector path reads both reflections before writing the same side ones
+		taps.Aliased = ESX_FALSE;
+		for (U32 tap = TapRDiffDelay; tap <= TapRDiffPrevious; tap++) {
+			taps.Aliased |= taps.Offsets[tap] == taps.Offsets[TapLSame] || taps.Offsets[tap] == taps.Offsets[TapRSame];
+		}
+
+		taps.Dirty = ESX_FALSE;
+	}
+
+	U32 SPU::getReverbTapAddress(ReverbTap tap) const
+	{
+		U32 relative = mReverbTaps.Offsets[tap] + mReverbTaps.Position;
+		if (relative >= mReverbTaps.Size) relative -= mReverbTaps.Size;
+		return (mReverbTaps.Base + relative) & 0x7FFFE;
+	}
+
+	I16 SPU::loadReverbTap(ReverbTap tap)
+	{
+		if (mReverbTaps.Checked) return loadReverb(mReverbTaps.Addresses[tap]);
+
+		return *(I16*)(mRAM.data() + getReverbTapAddress(tap));
+	}
+
+	void SPU::writeReverbTap(ReverbTap tap, I16 value)
+	{
+		if (mReverbTaps.Checked) return writeReverb(mReverbTaps.Addresses[tap], value);
+		if (mSPUControl.ReverbMasterEnable == ESX_FALSE) return;
+
+		U32 address = getReverbTapAddress(tap);
+		invalidateADPCMCache(address, sizeof(I16));
+		*(I16*)(mRAM.data() + address) = value;
+	}
+
+	BIT SPU::prepareVoice(Voice& voice)
+	{
+		U32 lane = voice.Number;
+		I16* samples = &mLanes.Samples[lane * 4];
+		I16* weights = &mLanes.Weights[lane * 4];
+
 		if (voice.ADSR.Phase == ADSRPhaseType::Off) {
-			voice.Latest = 0;
-			return {};
+			std::fill_n(weights, 4, 0);
+			mLanes.Noise[lane] = 0;
+			mLanes.Envelope[lane] = 0;
+			return ESX_FALSE;
 		}
 
 		if (mSPUControl.IRQ9Enable && voice.ADPCMCurrentAddress == mSoundRAMIRQAddress) {
@@ -822,8 +1032,7 @@ namespace esx {
 		}
 
 		if (!voice.HasSamples) {
-			ADPCMBlock currentBlock = readADPCMBlock(voice.ADPCMCurrentAddress);
-			decodeBlock(voice, currentBlock);
+			loadBlock(voice);
 			voice.HasSamples = ESX_TRUE;
 
 			if (voice.CurrentBlockFlags & 0b100) {
@@ -831,28 +1040,34 @@ namespace esx {
 			}
 		}
 
-		I32 volume = 0;
-		if (voice.ADSR.CurrentVolume != 0) {
-			I32 sample = 0;
+		U8 interpolationIndex = voice.getInterpolationIndex();
+		U8 sampleIndex = 3 + voice.getSampleIndex();
 
-			if (voice.NoiseMode == NoiseMode::Noise) {
-				sample = mNoiseLevel;
-			} else {
-				U8 interpolationIndex = voice.getInterpolationIndex();
-				U8 sampleIndex = 3 + voice.getSampleIndex();
+		samples[0] = voice.CurrentSamples[sampleIndex - 3];
+		samples[1] = voice.CurrentSamples[sampleIndex - 2];
+		samples[2] = voice.CurrentSamples[sampleIndex - 1];
+		samples[3] = voice.CurrentSamples[sampleIndex - 0];
 
-				sample =  gauss[0x0FF - interpolationIndex] * I32(voice.CurrentSamples[sampleIndex - 3]);
-				sample += gauss[0x1FF - interpolationIndex] * I32(voice.CurrentSamples[sampleIndex - 2]);
-				sample += gauss[0x100 + interpolationIndex] * I32(voice.CurrentSamples[sampleIndex - 1]);
-				sample += gauss[0x000 + interpolationIndex] * I32(voice.CurrentSamples[sampleIndex - 0]);
-				sample >>= 15;
-			}
+		weights[0] = gauss[0x0FF - interpolationIndex];
+		weights[1] = gauss[0x1FF - interpolationIndex];
+		weights[2] = gauss[0x100 + interpolationIndex];
+		weights[3] = gauss[0x000 + interpolationIndex];
 
-			volume = (sample * voice.ADSR.CurrentVolume) >> 15;
-		}
+		mLanes.Noise[lane] = (voice.NoiseMode == NoiseMode::Noise) ? -1 : 0;
+		mLanes.Envelope[lane] = voice.ADSR.CurrentVolume;
 
-		voice.Latest = volume;
+		return ESX_TRUE;
+	}
+
+	BIT SPU::isVoiceLive(const Voice& voice) const
+	{
+		//Sweeping volumes tick every sample even on a silent voice
+		return voice.ADSR.Phase != ADSRPhaseType::Off || voice.Latest != 0 || voice.KeyOn || voice.KeyOff ||
+			voice.VolumeLeft.VolumeMode == VolumeMode::Sweep || voice.VolumeRight.VolumeMode == VolumeMode::Sweep;
+	}
 
+	void SPU::advanceVoice(Voice& voice)
+	{
 		tickADSR(voice);
 
 		U16 step = voice.ADPCMSampleRate;
@@ -887,13 +1102,188 @@ namespace esx {
 				}
 			}
 		}
+	}
 
-		I32 left = (volume * processVolume(voice.VolumeLeft)) >> 15;
-		I32 right = (volume * processVolume(voice.VolumeRight)) >> 15;
+#ifdef ESX_SPU_SSE2
+	//Low 32 bits of a 32x32 multiply, identical for signed and unsigned operands
+	static inline __m128i mullo_epi32_sse2(__m128i a, __m128i b)
+	{
+		__m128i even = _mm_mul_epu32(a, b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
 
-		return std::make_pair(left, right);
+	static inline __m128i scale_sse2(__m128i a, const I32* b)
+	{
+		return _mm_srai_epi32(mullo_epi32_sse2(a, _mm_load_si128(reinterpret_cast<const __m128i*>(b))), 15);
 	}
 
+	static inline I32 horizontal_sum_sse2(__m128i a)
+	{
+		a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+		a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(a);
+	}
+#endif
+
+	void SPU::interpolateVoices()
+	{
+#ifdef ESX_SPU_SSE2
+		const __m128i noise = _mm_set1_epi32(mNoiseLevel);
+
+		for (U32 lane = 0; lane < VoiceLanes::COUNT; lane += 4) {
+			if (((mLiveVoices >> lane) & 0xF) == 0) continue;
+
+			//Each madd yields the two partial sums of two voices
+			__m128i lo = _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&mLanes.Samples[lane * 4 + 0])), _mm_load_si128(reinterpret_cast<const __m128i*>(&mLanes.Weights[lane * 4 + 0])));
+			__m128i hi = _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&mLanes.Samples[lane * 4 + 8])), _mm_load_si128(reinterpret_cast<const __m128i*>(&mLanes.Weights[lane * 4 + 8])));
+			__m128i even = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+			__m128i odd = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+			__m128i sample = _mm_srai_epi32(_mm_add_epi32(even, odd), 15);
+
+			__m128i noiseMask = _mm_load_si128(reinterpret_cast<const __m128i*>(&mLanes.Noise[lane]));
+			sample = _mm_or_si128(_mm_and_si128(noiseMask, noise), _mm_andnot_si128(noiseMask, sample));
+
+			_mm_store_si128(reinterpret_cast<__m128i*>(&mLanes.Latest[lane]), scale_sse2(sample, &mLanes.Envelope[lane]));
+		}
+#else
+		for (U32 lane = 0; lane < VoiceLanes::COUNT; lane++) {
+			const I16* samples = &mLanes.Samples[lane * 4];
+			const I16* weights = &mLanes.Weights[lane * 4];
+
+			I32 sample = mNoiseLevel;
+			if (mLanes.Noise[lane] == 0) {
+				sample =  weights[0] * I32(samples[0]);
+				sample += weights[1] * I32(samples[1]);
+				sample += weights[2] * I32(samples[2]);
+				sample += weights[3] * I32(samples[3]);
+				sample >>= 15;
+			}
+
+			mLanes.Latest[lane] = (sample * mLanes.Envelope[lane]) >> 15;
+		}
+#endif
+	}
+
+	void SPU::mixVoices(I32& leftSum, I32& rightSum, I32& reverbLeftSum, I32& reverbRightSum)
+	{
+#ifdef ESX_SPU_SSE2
+		__m128i mixLeft = _mm_setzero_si128(), mixRight = _mm_setzero_si128();
+		__m128i reverbLeft = _mm_setzero_si128(), reverbRight = _mm_setzero_si128();
+
+		for (U32 lane = 0; lane < VoiceLanes::COUNT; lane += 4) {
+			if (((mLiveVoices >> lane) & 0xF) == 0) continue;
+
+			__m128i latest = _mm_load_si128(reinterpret_cast<const __m128i*>(&mLanes.Latest[lane]));
+			__m128i left = scale_sse2(latest, &mLanes.VoiceLeft[lane]);
+			__m128i right = scale_sse2(latest, &mLanes.VoiceRight[lane]);
+
+			mixLeft = _mm_add_epi32(mixLeft, scale_sse2(left, &mLanes.MixLeft[lane]));
+			mixRight = _mm_add_epi32(mixRight, scale_sse2(right, &mLanes.MixRight[lane]));
+			reverbLeft = _mm_add_epi32(reverbLeft, scale_sse2(left, &mLanes.ReverbLeft[lane]));
+			reverbRight = _mm_add_epi32(reverbRight, scale_sse2(right, &mLanes.ReverbRight[lane]));
+		}
+
+		leftSum += horizontal_sum_sse2(mixLeft);
+		rightSum += horizontal_sum_sse2(mixRight);
+		reverbLeftSum += horizontal_sum_sse2(reverbLeft);
+		reverbRightSum += horizontal_sum_sse2(reverbRight);
+#else
+		for (U32 lane = 0; lane < VoiceLanes::COUNT; lane++) {
+			I32 left = (mLanes.Latest[lane] * mLanes.VoiceLeft[lane]) >> 15;
+			I32 right = (mLanes.Latest[lane] * mLanes.VoiceRight[lane]) >> 15;
+
+			leftSum += (left * mLanes.MixLeft[lane]) >> 15;
+			rightSum += (right * mLanes.MixRight[lane]) >> 15;
+			reverbLeftSum += (left * mLanes.ReverbLeft[lane]) >> 15;
+			reverbRightSum += (right * mLanes.ReverbRight[lane]) >> 15;
+		}
+#endif
+	}
+
+#ifdef ESX_SPU_SSE2
+	static inline __m128i mult_sse2(__m128i a, __m128i b)
+	{
+		return _mm_srai_epi32(mullo_epi32_sse2(a, b), 15);
+	}
+
+	//Clamp to the I16 range like SATURATE, keeping 32 bit lanes
+	static inline __m128i saturate_sse2(__m128i a)
+	{
+		__m128i packed = _mm_packs_epi32(a, a);
+		return _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+	}
+
+	//Wrap to I16 like an integer conversion
+	static inline __m128i truncate_sse2(__m128i a)
+	{
+		return _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	}
+
+	static inline I16 lane_sse2(__m128i a, I32 lane)
+	{
+		alignas(16) Array<I32, 4> lanes;
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes.data()), a);
+		return static_cast<I16>(lanes[lane]);
+	}
+
+	//Left and right run side by side, both reflections share one pass, same memory access order as reverbScalar
+	Pair<I16, I16> SPU::reverbSSE2(I16 LeftInput, I16 RightInput)
+	{
+		const __m128i firGain = _mm_set1_epi32(fir_filter_gain);
+
+		__m128i input = _mm_setr_epi32(LeftInput, RightInput, LeftInput, RightInput);
+		input = truncate_sse2(mult_sse2(input, firGain));
+		input = truncate_sse2(mult_sse2(input, _mm_setr_epi32(VOLUME(vLIN), VOLUME(vRIN), VOLUME(vLIN), VOLUME(vRIN))));
+
+		//Lanes are LSAME, RSAME, LDIFF and RDIFF
+		__m128i delayed = _mm_setr_epi32(loadReverbTap(TapLSameDelay), loadReverbTap(TapRSameDelay), loadReverbTap(TapRDiffDelay), loadReverbTap(TapLDiffDelay));
+		__m128i previous = _mm_setr_epi32(loadReverbTap(TapLSamePrevious), loadReverbTap(TapRSamePrevious), loadReverbTap(TapLDiffPrevious), loadReverbTap(TapRDiffPrevious));
+
+		__m128i reflection = _mm_sub_epi32(_mm_add_epi32(input, mult_sse2(delayed, _mm_set1_epi32(VOLUME(vWALL)))), previous);
+		reflection = saturate_sse2(_mm_add_epi32(mult_sse2(reflection, _mm_set1_epi32(VOLUME(vIIR))), previous));
+
+		writeReverbTap(TapLSame, lane_sse2(reflection, 0));
+		writeReverbTap(TapRSame, lane_sse2(reflection, 1));
+		writeReverbTap(TapLDiff, lane_sse2(reflection, 2));
+		writeReverbTap(TapRDiff, lane_sse2(reflection, 3));
+
+		//Every comb term is scaled on its own before the sum, so the products are widened instead of madd
+		__m128i comb = _mm_setr_epi16(
+			loadReverbTap(TapLComb1), loadReverbTap(TapLComb2), loadReverbTap(TapLComb3), loadReverbTap(TapLComb4),
+			loadReverbTap(TapRComb1), loadReverbTap(TapRComb2), loadReverbTap(TapRComb3), loadReverbTap(TapRComb4)
+		);
+		__m128i combVolume = _mm_setr_epi16(VOLUME(vCOMB1), VOLUME(vCOMB2), VOLUME(vCOMB3), VOLUME(vCOMB4), VOLUME(vCOMB1), VOLUME(vCOMB2), VOLUME(vCOMB3), VOLUME(vCOMB4));
+		__m128i productsLow = _mm_mullo_epi16(comb, combVolume);
+		__m128i productsHigh = _mm_mulhi_epi16(comb, combVolume);
+		__m128i left = _mm_srai_epi32(_mm_unpacklo_epi16(productsLow, productsHigh), 15);
+		__m128i right = _mm_srai_epi32(_mm_unpackhi_epi16(productsLow, productsHigh), 15);
+		__m128i out = _mm_add_epi32(_mm_unpacklo_epi32(left, right), _mm_unpackhi_epi32(left, right));
+		out = saturate_sse2(_mm_add_epi32(out, _mm_shuffle_epi32(out, _MM_SHUFFLE(1, 0, 3, 2))));
+
+		auto allPass = [&](ReverbTap leftDelay, ReverbTap rightDelay, ReverbTap leftTap, ReverbTap rightTap, I16 volume) {
+			__m128i apfVolume = _mm_set1_epi32(volume);
+
+			__m128i delay = _mm_setr_epi32(loadReverbTap(leftDelay), loadReverbTap(rightDelay), 0, 0);
+			out = saturate_sse2(_mm_sub_epi32(out, mult_sse2(delay, apfVolume)));
+
+			writeReverbTap(leftTap, lane_sse2(out, 0));
+			writeReverbTap(rightTap, lane_sse2(out, 1));
+
+			delay = _mm_setr_epi32(loadReverbTap(leftDelay), loadReverbTap(rightDelay), 0, 0);
+			out = saturate_sse2(_mm_add_epi32(mult_sse2(out, apfVolume), delay));
+		};
+
+		allPass(TapLAPF1Delay, TapRAPF1Delay, TapLAPF1, TapRAPF1, VOLUME(vAPF1));
+		allPass(TapLAPF2Delay, TapRAPF2Delay, TapLAPF2, TapRAPF2, VOLUME(vAPF2));
+
+		out = saturate_sse2(mult_sse2(out, _mm_setr_epi32(VOLUME(vLOUT), VOLUME(vROUT), 0, 0)));
+		out = truncate_sse2(mult_sse2(out, firGain));
+
+		return std::make_pair(lane_sse2(out, 0), lane_sse2(out, 1));
+	}
+#endif
+
 	I16 SPU::loadReverb(U16 address)
 	{
 		U32 relative = ((address << 3) + mCurrentBufferAddress - (mReverb[mBASE] << 3)) % (0x80000 - (mReverb[mBASE] << 3));
@@ -919,12 +1309,14 @@ namespace esx {
 			mSPUStatus.IRQ9Flag = ESX_TRUE;
 		}
 
+		invalidateADPCMCache(wrapped, sizeof(I16));
 		*(I16*)(mRAM.data() + wrapped) = value;
 	}
 
 	void SPU::writeCaptureBuffer(I32 index, I16 value)
 	{
 		U32 writeAddress = (index * 0x400) + mCaptureBufferPointer;
+		invalidateADPCMCache(writeAddress, sizeof(I16));
 		*reinterpret_cast<I16*>(&mRAM[writeAddress]) = value;
 		if (mSPUControl.IRQ9Enable && (writeAddress / 8) == mSoundRAMIRQAddress) {
 			getBus("Root")->getDevice<InterruptControl>("InterruptControl")->requestInterrupt(InterruptType::SPU, mSPUStatus.IRQ9Flag, ESX_TRUE);
@@ -967,6 +1359,104 @@ namespace esx {
 		return getVolume(mVoices[voice].VolumeLeft);
 	}
 
+	void SPU::writeToRAM(const U8* input, U32 size)
+	{
+		syncSamples();
+		checkTransferIRQ(size);
+
+		while (size > 0) {
+			U32 address = mCurrentTransferAddress & (mRAM.size() - 1);
+			U32 span = std::min<U32>(size, (U32)mRAM.size() - address);
+			invalidateADPCMCache(address, span);
+			std::memcpy(&mRAM[address], input, span);
+
+			mCurrentTransferAddress = (address + span) & (mRAM.size() - 1);
+			input += span;
+			size -= span;
+		}
+	}
+
+	void SPU::readFromRAM(U8* output, U32 size)
+	{
+		syncSamples();
+		checkTransferIRQ(size);
+
+		while (size > 0) {
+			U32 address = mCurrentTransferAddress & (mRAM.size() - 1);
+			U32 span = std::min<U32>(size, (U32)mRAM.size() - address);
+			std::memcpy(output, &mRAM[address], span);
+
+			mCurrentTransferAddress = (address + span) & (mRAM.size() - 1);
+			output += span;
+			size -= span;
+		}
+	}
+
+	void SPU::checkTransferIRQ(U32 size)
+	{
+		if (!mSPUControl.IRQ9Enable) return;
+
+		//Word by word the IRQ fires when a word starts inside the 8 byte block at the IRQ address
+		U32 mask = (U32)mRAM.size() - 1;
+		U32 start = mCurrentTransferAddress & mask;
+		U32 irqAddress = (mSoundRAMIRQAddress * 8) & mask;
+		BIT startsInside = ((start - irqAddress) & mask) < 8;
+		BIT reachesIRQ = ((irqAddress - start) & mask) < size;
+
+		if (startsInside || reachesIRQ) {
+			getBus("Root")->getDevice<InterruptControl>("InterruptControl")->requestInterrupt(InterruptType::SPU, mSPUStatus.IRQ9Flag, ESX_TRUE);
+			mSPUStatus.IRQ9Flag = ESX_TRUE;
+		}
+	}
+
+	void SPU::loadBlock(Voice& voice)
+	{
+		U16 address = voice.ADPCMCurrentAddress;
+		DecodedADPCMBlock& entry = mADPCMCache[address & (ADPCM_CACHE_SIZE - 1)];
+
+		if (entry.Valid && entry.Address == address && entry.History == voice.LastSamples) {
+			voice.CurrentSamples[2] = voice.CurrentSamples[voice.CurrentSamples.size() - 1];
+			voice.CurrentSamples[1] = voice.CurrentSamples[voice.CurrentSamples.size() - 2];
+			voice.CurrentSamples[0] = voice.CurrentSamples[voice.CurrentSamples.size() - 3];
+			std::copy(entry.Samples.begin(), entry.Samples.end(), voice.CurrentSamples.begin() + 3);
+
+			voice.LastSamples = { entry.Samples[27], entry.Samples[26] };
+			voice.CurrentBlockFlags = entry.Flags;
+			return;
+		}
+
+		entry.Address = address;
+		entry.Valid = ESX_TRUE;
+		entry.History = voice.LastSamples;
+
+		decodeBlock(voice, readADPCMBlock(address));
+
+		std::copy(voice.CurrentSamples.begin() + 3, voice.CurrentSamples.end(), entry.Samples.begin());
+		entry.Flags = voice.CurrentBlockFlags;
+	}
+
+	void SPU::invalidateADPCMCache(U32 address, U32 size)
+	{
+		//A block starts every 8 bytes and spans 16, so the one before the range overlaps it too
+		U32 firstBlock = (address / 8) - 1;
+		U32 numBlocks = ((address + size - 1) / 8) - (address / 8) + 2;
+
+		if (numBlocks >= ADPCM_CACHE_SIZE) {
+			for (DecodedADPCMBlock& entry : mADPCMCache) {
+				entry.Valid = ESX_FALSE;
+			}
+			return;
+		}
+
+		for (U32 i = 0; i < numBlocks; i++) {
+			U16 blockAddress = static_cast<U16>(firstBlock + i);
+			DecodedADPCMBlock& entry = mADPCMCache[blockAddress & (ADPCM_CACHE_SIZE - 1)];
+			if (entry.Address == blockAddress) {
+				entry.Valid = ESX_FALSE;
+			}
+		}
+	}
+
 	ADPCMBlock SPU::readADPCMBlock(U16 address)
 	{
 		ADPCMBlock block = {};
@@ -1016,6 +1506,7 @@ namespace esx {
 	void SPU::setVoiceVolumeLeft(U8 voice, U16 value)
 	{
 		setVolume(mVoices[voice].VolumeLeft, value);
+		mLiveVoices |= (1 << voice);
 	}
 
 	U16 SPU::getVoiceVolumeRight(U8 voice)
@@ -1026,6 +1517,7 @@ namespace esx {
 	void SPU::setVoiceVolumeRight(U8 voice, U16 value)
 	{
 		setVolume(mVoices[voice].VolumeRight, value);
+		mLiveVoices |= (1 << voice);
 	}
 
 	U16 SPU::getVoiceADPCMSampleRate(U8 voice)
@@ -1191,6 +1683,7 @@ namespace esx {
 		for (U32 i = 0; i < 16; i++) {
 			if (value & (1 << i)) {
 				mVoices[i].KeyOn = ESX_TRUE;
+				mLiveVoices |= (1 << i);
 			}
 		}
 	}
@@ -1200,6 +1693,7 @@ namespace esx {
 		for (U32 i = 0; i < 8; i++) {
 			if (value & (1 << i)) {
 				mVoices[16 + i].KeyOn = ESX_TRUE;
+				mLiveVoices |= (1 << (16 + i));
 			}
 		}
 	}
@@ -1406,16 +1900,10 @@ namespace esx {
 			mSPUStatus.IRQ9Flag = ESX_FALSE;
 		}
 
-		if (!oldEnable && mSPUControl.Enable) {
-			SchedulerEvent spuSample = {
-				.Type = SchedulerEventType::SPUSample,
-				.ClockStart = mCPU->getClocks(),
-				.ClockTarget = ((mCPU->getClocks() / 768) * 768) + 768,
-				.Reschedule = ESX_TRUE,
-				.RescheduleClocks = 768
-			};
-			Scheduler::UnScheduleAllEvents(SchedulerEventType::SPUSample);
-			Scheduler::ScheduleEvent(spuSample);
+		//Once started the sample clock keeps running on the same 768 cycle grid, store reschedules the next batch
+		if (!oldEnable && mSPUControl.Enable && !mSampling) {
+			mSampling = ESX_TRUE;
+			mNextSampleClock = ((mCPU->getClocks() / CLOCKS_PER_SAMPLE) * CLOCKS_PER_SAMPLE) + CLOCKS_PER_SAMPLE;
 		}
 	}
 
@@ -1608,24 +2096,12 @@ namespace esx {
 		}
 
 		mReverb[reg] = value;
+		mReverbTaps.Dirty = ESX_TRUE;
 	}
 
-	static Array<I16, 39> fir_filter_coefficients = {
-		 -0x0001,  0x0000,  0x0002,  0x0000, -0x000A,  0x0000,  0x0023,  0x0000,
-		 -0x0067,  0x0000,  0x010A,  0x0000, -0x0268,  0x0000,  0x0534,  0x0000,
-		 -0x0B90,  0x0000,  0x2806,  0x4000,  0x2806,  0x0000, -0x0B90,  0x0000,
-		  0x0534,  0x0000, -0x0268,  0x0000,  0x010A,  0x0000, -0x0067,  0x0000,
-		  0x0023,  0x0000, -0x000A,  0x0000,  0x0002,  0x0000, -0x0001,
-	};
 	I16 SPU::reverbFirFilter(I16 sample)
 	{
-		I32 output = 0;
-
-		for (I16 coefficient : fir_filter_coefficients) {
-			output += sample * coefficient;
-		}
-
-		return output >> 15;
+		return (sample * fir_filter_gain) >> 15;
 	}
 
 }
\ No newline at end of file
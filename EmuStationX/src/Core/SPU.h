@@ -7,6 +7,10 @@
 #include "Base/CDBase.h"
 #include "InterruptControl.h"
 
+#include "Utils/AudioRing.h"
+#include "Utils/TimeStretch.h"
+#include "Utils/AudioCapture.h"
+
 namespace esx {
 
 	enum class VolumeMode : U8 {
@@ -75,6 +79,39 @@ namespace esx {
 		vRIN
 	};
 
+	//Work area accesses of one reverb tick in the order SPU::reverb performs them
+	enum ReverbTap {
+		TapLSameDelay,
+		TapRSameDelay,
+		TapLSamePrevious,
+		TapRSamePrevious,
+		TapLSame,
+		TapRSame,
+		TapRDiffDelay,
+		TapLDiffDelay,
+		TapLDiffPrevious,
+		TapRDiffPrevious,
+		TapLDiff,
+		TapRDiff,
+		TapLComb1,
+		TapLComb2,
+		TapLComb3,
+		TapLComb4,
+		TapRComb1,
+		TapRComb2,
+		TapRComb3,
+		TapRComb4,
+		TapLAPF1Delay,
+		TapRAPF1Delay,
+		TapLAPF1,
+		TapRAPF1,
+		TapLAPF2Delay,
+		TapRAPF2Delay,
+		TapLAPF2,
+		TapRAPF2,
+		TapCount
+	};
+
 	enum class EnvelopeMode : U8 {
 		Linear,
 		Exponential
@@ -147,6 +184,27 @@ namespace esx {
 		}
 	};
 
+	//28 samples decoded from the block at Address starting from the History filter state
+	struct DecodedADPCMBlock {
+		U16 Address = 0;
+		BIT Valid = ESX_FALSE;
+		U8 Flags = 0;
+		Array<I16, 2> History = {};
+		Array<I16, 28> Samples = {};
+	};
+
+	//Reverb taps resolved against mBASE once per register change, only the buffer position moves per tick
+	struct ReverbTaps {
+		BIT Dirty = ESX_TRUE;
+		BIT Checked = ESX_FALSE;
+		BIT Aliased = ESX_FALSE;
+		U32 Base = 0;
+		U32 Size = 0;
+		U32 Position = 0;
+		Array<U16, TapCount> Addresses = {};
+		Array<U32, TapCount> Offsets = {};
+	};
+
 	struct ADSR {
 		Array<EnvelopePhase, 4> Phases = {
 			EnvelopePhase(EnvelopeMode::Linear,EnvelopeDirection::Increase,0x00,0x00,0x7FFF),//Attack
@@ -242,6 +300,24 @@ namespace esx {
 		TransferMode TransferMode = TransferMode::Stop;
 	};
 
+	//Per sample mixer state of all voices, one array per stage so the stages run across voices
+	struct VoiceLanes {
+		static constexpr U32 COUNT = 24;
+
+		alignas(16) Array<I16, COUNT * 4> Samples = {};
+		alignas(16) Array<I16, COUNT * 4> Weights = {};
+		alignas(16) Array<I32, COUNT> Noise = {};
+		alignas(16) Array<I32, COUNT> Envelope = {};
+		alignas(16) Array<I32, COUNT> Latest = {};
+		alignas(16) Array<I32, COUNT> VoiceLeft = {};
+		alignas(16) Array<I32, COUNT> VoiceRight = {};
+		alignas(16) Array<I32, COUNT> MixLeft = {};
+		alignas(16) Array<I32, COUNT> MixRight = {};
+		alignas(16) Array<I32, COUNT> ReverbLeft = {};
+		alignas(16) Array<I32, COUNT> ReverbRight = {};
+		Array<BIT, COUNT> Active = {};
+	};
+
 	#define SATURATE(x) std::clamp((x), -0x8000, 0x7FFF)
 
 	class R3000;
@@ -255,6 +331,8 @@ namespace esx {
 		~SPU();
 
 		void sampleClock(U64 clocks);
+		void renderSamples(U64 targetClock);
+		void syncSamples();
 
 		virtual void store(const StringView& busName, U32 address, U16 value) override;
 		virtual void load(const StringView& busName, U32 address, U16& output) override;
@@ -272,6 +350,7 @@ namespace esx {
 				mSPUStatus.IRQ9Flag = ESX_TRUE;
 			}
 
+			invalidateADPCMCache(mCurrentTransferAddress, sizeof(T));
 			*reinterpret_cast<T*>(&mRAM[mCurrentTransferAddress]) = value;
 			mCurrentTransferAddress += sizeof(T);
 		}
@@ -288,14 +367,34 @@ namespace esx {
 			return value;
 		}
 
+		void writeToRAM(const U8* input, U32 size);
+		void readFromRAM(U8* output, U32 size);
+
 	private:
+		void checkTransferIRQ(U32 size);
+
 		ADPCMBlock readADPCMBlock(U16 address);
 		void decodeBlock(Voice& voice, const ADPCMBlock& block);
+		void loadBlock(Voice& voice);
+		void invalidateADPCMCache(U32 address, U32 size);
 
-		Pair<I32, I32> sampleVoice(Voice& voice);
+		U32 samplesUntilPossibleIRQ() const;
+		void scheduleSampleEvent(BIT unschedule = ESX_TRUE);
+
+		BIT prepareVoice(Voice& voice);
+		void advanceVoice(Voice& voice);
+		BIT isVoiceLive(const Voice& voice) const;
+		void interpolateVoices();
+		void mixVoices(I32& leftSum, I32& rightSum, I32& reverbLeftSum, I32& reverbRightSum);
 		void tickADSR(Voice& voice);
 
 		Pair<I16, I16> reverb(I16 LeftInput, I16 RightInput);
+		Pair<I16, I16> reverbScalar(I16 LeftInput, I16 RightInput);
+		Pair<I16, I16> reverbSSE2(I16 LeftInput, I16 RightInput);
+		void updateReverbTaps();
+		U32 getReverbTapAddress(ReverbTap tap) const;
+		I16 loadReverbTap(ReverbTap tap);
+		void writeReverbTap(ReverbTap tap, I16 value);
 		I16 loadReverb(U16 addr);
 		void writeReverb(U16 addr,I16 value);
 
@@ -432,6 +531,8 @@ namespace esx {
 		SharedPtr<CDROM> mCDROM;
 
 		Array<Voice, 24> mVoices = {};
+		VoiceLanes mLanes = {};
+		U32 mLiveVoices = 0;
 		Volume mMainVolumeLeft = {};
 		Volume mMainVolumeRight = {};
 		StereoVolume mCurrentMainVolume = {};
@@ -452,15 +553,30 @@ namespace esx {
 		//Reverb configuration Area
 		Array<U16, 35> mReverb = {};
 		U32 mCurrentBufferAddress = 0x00000000;
+		ReverbTaps mReverbTaps = {};
 
 		Queue<U16> mFIFO = {};
 		Vector<U8> mRAM = {};
 
+		static constexpr U32 ADPCM_CACHE_SIZE = 4096;
+		Array<DecodedADPCMBlock, ADPCM_CACHE_SIZE> mADPCMCache = {};
+
 		U32 mCurrentTransferAddress = 0;
-	public:
-		std::mutex mSamplesMutex = {};
 
-		AudioBatch mBackBuffer = {}, mFrontBuffer = {};
+		//Samples are rendered lazily in batches, the scheduler only wakes the SPU where an IRQ could fire
+		static constexpr U64 CLOCKS_PER_SAMPLE = 768;
+		static constexpr U32 MAX_BATCH_SAMPLES = 128;
+		BIT mSampling = ESX_FALSE;
+		U64 mNextSampleClock = 0;
+	public:
+		AudioRing mAudioRing = {};
+		TimeStretch mTimeStretch = {};
+
+		//Final mix, raw CD audio and a single voice after its own volume
+		AudioCapture mMixCapture = {};
+		AudioCapture mCDCapture = {};
+		AudioCapture mVoiceCapture = {};
+		U8 mCaptureVoice = 0;
 		U32 mCurrentSample = 0;
 	};
 
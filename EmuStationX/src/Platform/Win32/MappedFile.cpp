@@ -0,0 +1,62 @@
+#include "MappedFile.h"
+
+namespace esx::platform {
+
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        //Disc images are mostly read front to back, the flag is the MADV_SEQUENTIAL hint for the cache manager
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            ESX_CORE_LOG_ERROR("CreateFile failed with {} code", GetLastError());
+            return;
+        }
+
+        LARGE_INTEGER size = {};
+        if (GetFileSizeEx(hFile, &size) == FALSE || size.QuadPart == 0) {
+            CloseHandle(hFile);
+            return;
+        }
+
+        HANDLE hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (hMapping == NULL) {
+            ESX_CORE_LOG_ERROR("CreateFileMapping failed with {} code", GetLastError());
+            CloseHandle(hFile);
+            return;
+        }
+
+        LPVOID data = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == NULL) {
+            ESX_CORE_LOG_ERROR("MapViewOfFile failed with {} code", GetLastError());
+            CloseHandle(hMapping);
+            CloseHandle(hFile);
+            return;
+        }
+
+        mFileHandle = hFile;
+        mMappingHandle = hMapping;
+        mData = reinterpret_cast<const U8*>(data);
+        mSize = size.QuadPart;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mData) UnmapViewOfFile(mData);
+        if (mMappingHandle) CloseHandle(mMappingHandle);
+        if (mFileHandle != INVALID_HANDLE_VALUE) CloseHandle(mFileHandle);
+    }
+
+    void MappedFile::WillNeed(U64 offset)
+    {
+        if (mData == nullptr || offset >= mSize) return;
+        if (offset >= mAdvisedStart && offset + WILL_NEED_SIZE / 2 < mAdvisedEnd) return;
+
+        mAdvisedStart = offset;
+        mAdvisedEnd = std::min(offset + WILL_NEED_SIZE, mSize);
+
+        WIN32_MEMORY_RANGE_ENTRY range = {};
+        range.VirtualAddress = const_cast<U8*>(mData + mAdvisedStart);
+        range.NumberOfBytes = mAdvisedEnd - mAdvisedStart;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+
+#include "Base/Base.h"
+
+#include "Utils/LoggingSystem.h"
+
+#include <Windows.h>
+
+namespace esx::platform {
+
+	//Read only view of a whole file. Instances mapping the same file share its pages in the system cache.
+	class MappedFile {
+	public:
+		MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		BIT IsOpen() const { return mData != nullptr; }
+		const U8* GetData() const { return mData; }
+		U64 GetSize() const { return mSize; }
+
+		//Asks the memory manager to page in the range following offset, the madvise(MADV_WILLNEED) equivalent.
+		//Cheap to call on every read, a new request is only issued once offset gets close to the end of the last one.
+		void WillNeed(U64 offset);
+
+	public:
+		static constexpr U64 WILL_NEED_SIZE = 256 * 0x930;
+
+	private:
+		HANDLE mFileHandle = INVALID_HANDLE_VALUE;
+		HANDLE mMappingHandle = NULL;
+		const U8* mData = nullptr;
+		U64 mSize = 0;
+
+		U64 mAdvisedStart = 0;
+		U64 mAdvisedEnd = 0;
+	};
+
+}
@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 
 #include "Utils/Geometry.h"
+#include "Utils/LoggingSystem.h"
 
 namespace esx {
 
@@ -23,7 +24,12 @@ namespace esx {
 			BufferElement("aBPP", ShaderType::UByte1),
 			BufferElement("aSemiTransparency", ShaderType::UByte1),
 			BufferElement("aDither", ShaderType::UByte1),
-			BufferElement("aRawTexture", ShaderType::UByte1)
+			BufferElement("aRawTexture", ShaderType::UByte1),
+			BufferElement("aDrawTopLeft", ShaderType::UShort2),
+			BufferElement("aDrawBottomRight", ShaderType::UShort2),
+			BufferElement("aForceAlpha", ShaderType::UByte1),
+			BufferElement("aCheckMask", ShaderType::UByte1),
+			BufferElement("aTexPage", ShaderType::UShort2)
 		};
 
 		mTriVBO = MakeShared<VertexBuffer>();
@@ -59,13 +65,19 @@ namespace esx {
 		mFBO24->setColorAttachment(mTexture24);
 		mFBO24->init();
 
+		mTextureCopy = MakeShared<Texture2D>(2);
+		mTextureCopy->setData(nullptr, 1024, 512, InternalFormat::RGB5_A1, DataType::UnsignedShort1_555, DataFormat::RGBA);
+		mTextureCopy->unbind();
+
+		mTextureCache = MakeShared<TextureCache>();
+
 		/*mPBO24Up = MakeShared<PixelBuffer>();
 		mPBO24Up->setData(nullptr, 682 * 512 * sizeof(U8) * 3, BufferMode::Write);
 		mPBO24Up->unbind();*/
 
-		mPBO16Up = MakeShared<PixelBuffer>();
-		mPBO16Up->setData(nullptr, 1024 * 512 * sizeof(VRAMColor), BufferMode::Write);
-		mPBO16Up->unbind();
+		mPBO16Down = MakeShared<PixelBuffer>(PixelBufferTarget::Pack);
+		mPBO16Down->setData(nullptr, 1024 * 512 * sizeof(VRAMColor), BufferMode::Read);
+		mPBO16Down->unbind();
 
 		mVRAM16.resize(1024 * 512);
 
@@ -82,6 +94,10 @@ namespace esx {
 		mTriCurrentVertex = mTriVerticesBase.begin();
 		mLineStripCurrentVertex = mLineStripVerticesBase.begin();
 		mLineStripCurrentIndex = mLineStripIndicesBase.begin();
+		mTriangleGrid.clear();
+		mDrawnTiles.clear();
+		mLineTiles.clear();
+		mBatchCounter++;
 	}
 
 	void BatchRenderer::end()
@@ -92,26 +108,34 @@ namespace esx {
 
 	void BatchRenderer::Flush()
 	{
+		if (mSkipRendering) {
+			deferBatch();
+			return;
+		}
+
 		ptrdiff_t numTriIndices = std::distance(mTriVerticesBase.begin(), mTriCurrentVertex);
 		ptrdiff_t numLineStripIndices = std::distance(mLineStripVerticesBase.begin(), mLineStripCurrentVertex);
 
+		rasterize(mTriVerticesBase.data(), numTriIndices, mLineStripVerticesBase.data(), mLineStripIndicesBase.data(), numLineStripIndices);
+	}
 
+	void BatchRenderer::rasterize(const PolygonVertex* triangles, size_t numTriIndices, const PolygonVertex* lineVertices, const U32* lineIndices, size_t numLineStripIndices)
+	{
 		if (numTriIndices > 0 || numLineStripIndices > 0) {
 			mFBO16->bind();
 
+			//Drawing area and mask settings travel with each vertex and are applied in the shader
 			glViewport(0, 0, mFBO16->width(), mFBO16->height());
-			glScissor(mDrawTopLeft.x, 511 - mDrawBottomRight.y, (mDrawBottomRight.x - mDrawTopLeft.x) + 1, (mDrawBottomRight.y - mDrawTopLeft.y) + 1);
+			glScissor(0, 0, mFBO16->width(), mFBO16->height());
 
 			mShader->start();
 
-			mShader->uploadUniform("uCheckMask", mCheckMask);
-			mShader->uploadUniform("uForceAlpha", mForceAlpha);
-
 			mFBO16->getColorAttachment()->bind();
+			mTextureCache->bind();
 
 			if (numTriIndices > 0) {
 				mTriVBO->bind();
-				mTriVBO->copyData(mTriVerticesBase.data(), numTriIndices * sizeof(PolygonVertex));
+				mTriVBO->copyData(triangles, numTriIndices * sizeof(PolygonVertex));
 				mTriVAO->bind();
 				glDrawArrays(GL_TRIANGLES, 0, (GLsizei)numTriIndices);
 			}
@@ -124,17 +148,18 @@ namespace esx {
 				glPrimitiveRestartIndex(-1);
 
 				mLineStripVBO->bind();
-				mLineStripVBO->copyData(mLineStripVerticesBase.data(), numLineStripIndices * sizeof(PolygonVertex));
+				mLineStripVBO->copyData(lineVertices, numLineStripIndices * sizeof(PolygonVertex));
 				mLineStripIBO->bind();
-				mLineStripIBO->copyData(mLineStripIndicesBase.data(), numLineStripIndices * sizeof(U32));
+				mLineStripIBO->copyData(lineIndices, numLineStripIndices * sizeof(U32));
 
 				mLineStripVAO->bind();
-				glDrawElements(GL_LINE_STRIP, numLineStripIndices, GL_UNSIGNED_INT, nullptr);
+				glDrawElements(GL_LINE_STRIP, (GLsizei)numLineStripIndices, GL_UNSIGNED_INT, nullptr);
 
 
 				glDisable(GL_PRIMITIVE_RESTART);
 			}
 
+			mTextureCache->unbind();
 			mFBO16->getColorAttachment()->unbind();
 			mShader->stop();
 			mFBO16->unbind();
@@ -143,6 +168,122 @@ namespace esx {
 		}
 	}
 
+	void BatchRenderer::deferBatch()
+	{
+		if (!hasPendingDraws()) return;
+
+		SkippedBatch& batch = mSkippedBatches.emplace_back();
+		batch.Triangles.assign(mTriVerticesBase.begin(), mTriCurrentVertex);
+		batch.LineVertices.assign(mLineStripVerticesBase.begin(), mLineStripCurrentVertex);
+		batch.LineIndices.assign(mLineStripIndicesBase.begin(), mLineStripCurrentIndex);
+		markSkippedBatch(batch);
+		mSkippedVertices += batch.Triangles.size() + batch.LineVertices.size();
+
+		mTriCurrentVertex = mTriVerticesBase.begin();
+		mLineStripCurrentVertex = mLineStripVerticesBase.begin();
+		mLineStripCurrentIndex = mLineStripIndicesBase.begin();
+
+		//Long runs of skipped frames that nothing depends on are drawn anyway to bound the memory
+		if (mSkippedVertices >= MAX_SKIPPED_VERTICES) {
+			drawSkippedBatches();
+		}
+	}
+
+	void BatchRenderer::drawSkippedBatches()
+	{
+		if (mSkippedBatches.empty()) return;
+
+		//Pending VRAM writes either came first or do not touch the skipped primitives
+		FlushVRAMWrites();
+		for (const SkippedBatch& batch : mSkippedBatches) {
+			rasterize(batch.Triangles.data(), batch.Triangles.size(), batch.LineVertices.data(), batch.LineIndices.data(), batch.LineIndices.size());
+		}
+
+		mSkippedBatches.clear();
+		mSkippedVertices = 0;
+		mSkippedTiles.clear();
+		mSkippedSourceTiles.clear();
+	}
+
+	void BatchRenderer::pruneSkippedBatches(const BoundingBox& area)
+	{
+		//Skipped primitives that get overwritten as a whole are dropped, unless a later one samples them
+		if (mSkippedBatches.empty() || mSkippedSourceTiles.test(area)) return;
+
+		mSkippedVertices = 0;
+		mSkippedTiles.clear();
+		mSkippedSourceTiles.clear();
+
+		for (SkippedBatch& batch : mSkippedBatches) {
+			auto keptVertex = batch.Triangles.begin();
+			for (auto it = batch.Triangles.begin(); it != batch.Triangles.end(); it += 3) {
+				BoundingBox drawnArea = getDrawnArea(&*it, 3);
+				if (drawnArea.empty() || area.contains(drawnArea)) {
+					continue;
+				}
+
+				keptVertex = std::copy(it, it + 3, keptVertex);
+			}
+			batch.Triangles.erase(keptVertex, batch.Triangles.end());
+
+			size_t keptIndex = 0;
+			size_t first = 0;
+			for (size_t i = 0; i < batch.LineIndices.size(); i++) {
+				if (batch.LineIndices[i] != (U32)-1) continue;
+
+				U32 count = (U32)(i - first);
+				BoundingBox drawnArea = getDrawnArea(&batch.LineVertices[first], count);
+				if (!drawnArea.empty() && !area.contains(drawnArea)) {
+					for (U32 j = 0; j < count; j++) {
+						batch.LineIndices[keptIndex] = (U32)keptIndex;
+						batch.LineVertices[keptIndex++] = batch.LineVertices[first + j];
+					}
+					batch.LineIndices[keptIndex++] = -1;
+				}
+
+				first = i + 1;
+			}
+			batch.LineIndices.resize(keptIndex);
+			batch.LineVertices.resize(keptIndex);
+
+			markSkippedBatch(batch);
+			mSkippedVertices += batch.Triangles.size() + batch.LineVertices.size();
+		}
+
+		std::erase_if(mSkippedBatches, [](const SkippedBatch& batch) { return batch.Triangles.empty() && batch.LineIndices.empty(); });
+	}
+
+	void BatchRenderer::markSkippedBatch(const SkippedBatch& batch)
+	{
+		for (size_t i = 0; i < batch.Triangles.size(); i += 3) {
+			const PolygonVertex* triangle = &batch.Triangles[i];
+			mSkippedTiles.mark(getDrawnArea(triangle, 3));
+			if (triangle->textured) {
+				mSkippedSourceTiles.mark(getTextureFootprint(triangle, 3));
+			}
+		}
+
+		size_t first = 0;
+		for (size_t i = 0; i < batch.LineIndices.size(); i++) {
+			if (batch.LineIndices[i] != (U32)-1) continue;
+
+			mSkippedTiles.mark(getDrawnArea(&batch.LineVertices[first], (U32)(i - first)));
+			first = i + 1;
+		}
+	}
+
+	void BatchRenderer::resolveSkipped(const VRAMRect& rect, BIT written)
+	{
+		if (mSkippedBatches.empty()) return;
+
+		forEachWrappedRect(rect, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+			BoundingBox area = { (I32)x, (I32)y, (I32)(x + w - 1), (I32)(y + h - 1) };
+			if (mSkippedTiles.test(area) || (written && mSkippedSourceTiles.test(area))) {
+				drawSkippedBatches();
+			}
+		});
+	}
+
 	void BatchRenderer::SetDrawOffset(I16 offsetX, I16 offsetY)
 	{
 		mDrawOffset.x = offsetX;
@@ -152,10 +293,6 @@ namespace esx {
 
 	void BatchRenderer::SetDrawTopLeft(U16 x, U16 y)
 	{
-		FlushVRAMWrites();
-		Flush();
-		Begin();
-
 		mDrawTopLeft.x = x;
 		mDrawTopLeft.y = y;
 
@@ -164,10 +301,6 @@ namespace esx {
 
 	void BatchRenderer::SetDrawBottomRight(U16 x, U16 y)
 	{
-		FlushVRAMWrites();
-		Flush();
-		Begin();
-
 		mDrawBottomRight.x = x;
 		mDrawBottomRight.y = y;
 
@@ -177,19 +310,11 @@ namespace esx {
 
 	void BatchRenderer::SetForceAlpha(BIT value)
 	{
-		FlushVRAMWrites();
-		Flush();
-		Begin();
-
 		mForceAlpha = value;
 	}
 
 	void BatchRenderer::SetCheckMask(BIT value)
 	{
-		FlushVRAMWrites();
-		Flush();
-		Begin();
-
 		mCheckMask = value;
 	}
 
@@ -198,31 +323,93 @@ namespace esx {
 		m24Bit = value;
 	}
 
+	void BatchRenderer::SetSkipRendering(BIT value)
+	{
+		if (value != mSkipRendering && hasPendingDraws()) {
+			FlushVRAMWrites();
+			Flush();
+			Begin();
+		}
+
+		mSkipRendering = value;
+	}
+
 	void BatchRenderer::Clear(U16 x, U16 y, U16 w, U16 h, Color& color)
 	{
-		FlushVRAMWrites();
-		Flush();
-		Begin();
+		//Fills are batched as flat quads, they ignore the drawing area and the mask settings
+		Array<PolygonVertex, 4> vertices = {};
+		for (PolygonVertex& vertex : vertices) {
+			vertex.color = color;
+			vertex.semiTransparency = 255;
+			vertex.drawTopLeft = UV(0, 0);
+			vertex.drawBottomRight = UV(1023, 511);
+		}
 
-		mFBO16->bind();
-		glScissor(x, 511 - y - (h - 1), w, h);
-		glClearColor((color.r >> 3) / 31.0, (color.g >> 3) / 31.0, (color.b >> 3) / 31.0, 0);
-		glClear(GL_COLOR_BUFFER_BIT);
-		mFBO16->unbind();
+		vertices[0].vertex = Vertex(x + w, y + h);
+		vertices[1].vertex = Vertex(x, y + h);
+		vertices[2].vertex = Vertex(x + w, y);
+		vertices[3].vertex = Vertex(x, y);
 
-		mRefreshVRAMData = ESX_TRUE;
+		pruneSkippedBatches(BoundingBox{ x, y, x + w - 1, y + h - 1 });
+		pushPolygon(vertices, 4);
 	}
 
 	void BatchRenderer::DrawPolygon(Array<PolygonVertex, 4>& vertices, U32 numVertices)
+	{
+		drawPolygon(vertices.data(), numVertices);
+	}
+
+	void BatchRenderer::Submit(PrimitiveBatch& batch)
+	{
+		for (const Primitive& primitive : batch.Primitives) {
+			PolygonVertex* vertices = &batch.Vertices[primitive.FirstVertex];
+
+			switch (primitive.Type) {
+				case PrimitiveType::Polygon: {
+					drawPolygon(vertices, primitive.NumVertices);
+					break;
+				}
+
+				case PrimitiveType::LineStrip: {
+					drawLineStrip(vertices, primitive.NumVertices);
+					break;
+				}
+			}
+		}
+	}
+
+	void BatchRenderer::drawPolygon(const PolygonVertex* source, U32 numVertices)
 	{
 		//ESX_CORE_LOG_TRACE("BatchRenderer::DrawPolygon");
-		for (PolygonVertex& vertex : vertices) {
+		Array<PolygonVertex, 4> vertices = {};
+		for (U32 i = 0; i < numVertices; i++) {
+			PolygonVertex& vertex = vertices[i];
+			vertex = source[i];
 			vertex.vertex.x += mDrawOffset.x;
 			vertex.vertex.y += mDrawOffset.y;
+			applyDrawState(vertex);
 
 			//ESX_CORE_LOG_TRACE(" Vertex({},{}),Color({},{},{}),UV({},{}),ClutUV({},{}),Textured({})", vertex.vertex.x, vertex.vertex.y, vertex.color.r, vertex.color.g, vertex.color.b, vertex.uv.u, vertex.uv.v, vertex.clutUV.u,vertex.clutUV.v, vertex.textured);
 		}
 
+		pushPolygon(vertices, numVertices);
+	}
+
+	void BatchRenderer::pushPolygon(Array<PolygonVertex, 4>& vertices, U32 numVertices)
+	{
+		//Skipped primitives land first when a drawn one covers, samples or overwrites what they draw or sample
+		if (!mSkipRendering && !mSkippedBatches.empty()) {
+			BoundingBox drawnArea = getDrawnArea(vertices.data(), numVertices);
+			BIT dependent = mSkippedTiles.test(drawnArea) || mSkippedSourceTiles.test(drawnArea);
+			if (!dependent && vertices.at(0).textured) {
+				dependent = mSkippedTiles.test(getTextureFootprint(vertices.data(), numVertices));
+			}
+
+			if (dependent) {
+				drawSkippedBatches();
+			}
+		}
+
 		ptrdiff_t numIndices = std::distance(mTriVerticesBase.begin(), mTriCurrentVertex);
 		if ((numIndices + vertices.size()) >= TRI_MAX_VERTICES /* || (numIndices > 0 && vertices.at(0).semiTransparency != 255)*/) {
 			FlushVRAMWrites();
@@ -230,37 +417,25 @@ namespace esx {
 			Begin();
 		}
 
-		if (numIndices > 0 && vertices.at(0).semiTransparency != 255) {
-			BIT overlapped = ESX_FALSE;
-
-			Vertex& triA_a = vertices.at(0).vertex;
-			Vertex& triA_b = vertices.at(1).vertex;
-			Vertex& triA_c = vertices.at(2).vertex;
-			for (auto it = mTriVerticesBase.begin(); it < mTriCurrentVertex;) {
-				Vertex& triB_a = it->vertex; it++;
-				Vertex& triB_b = it->vertex; it++;
-				Vertex& triB_c = it->vertex; it++;
+		//Lines are drawn after every triangle of the batch, a triangle over a queued line has to wait for it
+		//Sampling VRAM drawn by this batch needs the batch on the framebuffer first
+		if (mLineTiles.test(getDrawnArea(vertices.data(), numVertices)) || (vertices.at(0).textured && mDrawnTiles.test(getTextureFootprint(vertices.data(), numVertices)))) {
+			FlushVRAMWrites();
+			Flush();
+			Begin();
+		}
 
-				if (checkOverlap(triA_a, triA_b, triA_c, triB_a, triB_b, triB_c)) {
-					overlapped = ESX_TRUE;
-					break;
-				}
+		if (hasPendingDraws() && (vertices.at(0).semiTransparency != 255 || vertices.at(0).checkMask)) {
+			//Index lazily, batches without blending or mask tests never touch the grid
+			size_t numTriangles = std::distance(mTriVerticesBase.begin(), mTriCurrentVertex) / 3;
+			while (mTriangleGrid.size() < numTriangles) {
+				auto it = mTriVerticesBase.begin() + (mTriangleGrid.size() * 3);
+				mTriangleGrid.insert(it[0].vertex, it[1].vertex, it[2].vertex);
 			}
 
+			BIT overlapped = mTriangleGrid.overlaps(vertices.at(0).vertex, vertices.at(1).vertex, vertices.at(2).vertex);
 			if (!overlapped && numVertices == 4) {
-				Vertex& triA_a = vertices.at(1).vertex;
-				Vertex& triA_b = vertices.at(2).vertex;
-				Vertex& triA_c = vertices.at(3).vertex;
-				for (auto it = mTriVerticesBase.begin(); it < mTriCurrentVertex;) {
-					Vertex& triB_a = it->vertex; it++;
-					Vertex& triB_b = it->vertex; it++;
-					Vertex& triB_c = it->vertex; it++;
-
-					if (checkOverlap(triA_a, triA_b, triA_c, triB_a, triB_b, triB_c)) {
-						overlapped = ESX_TRUE;
-						break;
-					}
-				}
+				overlapped = mTriangleGrid.overlaps(vertices.at(1).vertex, vertices.at(2).vertex, vertices.at(3).vertex);
 			}
 
 			if (overlapped) {
@@ -270,6 +445,11 @@ namespace esx {
 			}
 		}
 
+		//Skipped primitives may be drawn long after their cache slot got reused, they sample VRAM directly
+		if (mTextureCacheEnabled && !mSkipRendering && vertices.at(0).textured && vertices.at(0).bpp != 16) {
+			applyTextureCache(vertices, numVertices);
+		}
+
 		for (U64 i = 0; i < 3; i++) {
 			const PolygonVertex& vertex = vertices[i];
 
@@ -285,23 +465,135 @@ namespace esx {
 				mTriCurrentVertex++;
 			}
 		}
+
+		markDrawnArea(getDrawnArea(vertices.data(), numVertices));
+	}
+
+	void BatchRenderer::applyDrawState(PolygonVertex& vertex) const
+	{
+		vertex.drawTopLeft = UV(mDrawTopLeft.x, mDrawTopLeft.y);
+		vertex.drawBottomRight = UV(mDrawBottomRight.x, mDrawBottomRight.y);
+		vertex.forceAlpha = mForceAlpha;
+		vertex.checkMask = mCheckMask;
+	}
+
+	void BatchRenderer::applyTextureCache(Array<PolygonVertex, 4>& vertices, U32 numVertices)
+	{
+		TexturePageKey key = TextureCache::GetKey(vertices.at(0));
+
+		I32 slot = mTextureCache->find(key);
+		if (slot < 0) {
+			slot = mTextureCache->getVictim();
+
+			//The page is decoded from the framebuffer, anything queued on it or on the slot must land first
+			const TexturePageEntry& victim = mTextureCache->getEntry(slot);
+			I32 texelsPerPixel = 16 / key.BPP;
+			BoundingBox pageArea = { key.PageX / texelsPerPixel, key.PageY, (key.PageX / texelsPerPixel) + (256 / texelsPerPixel) - 1, key.PageY + 255 };
+			BoundingBox clutArea = { key.ClutX, key.ClutY, key.ClutX + (key.BPP == 4 ? 15 : 255), key.ClutY };
+			if (hasPendingDraws() && (victim.LastBatch == mBatchCounter || mDrawnTiles.test(pageArea) || mDrawnTiles.test(clutArea))) {
+				FlushVRAMWrites();
+				Flush();
+				Begin();
+			}
+
+			if (mSkippedTiles.test(pageArea) || mSkippedTiles.test(clutArea)) {
+				drawSkippedBatches();
+			}
+
+			FlushVRAMWrites();
+			mTextureCache->decode(slot, key, mTexture16);
+		}
+		mTextureCache->use(slot, mBatchCounter);
+
+		UV origin = mTextureCache->getSlotOrigin(slot);
+		for (U32 i = 0; i < numVertices; i++) {
+			PolygonVertex& vertex = vertices[i];
+			vertex.uv = UV(vertex.uv.u - key.PageX, vertex.uv.v - key.PageY);
+			vertex.clutUV = origin;
+			vertex.bpp = 0;
+		}
+	}
+
+	void BatchRenderer::markDrawnArea(const BoundingBox& area)
+	{
+		if (!area.empty()) {
+			mDrawnTiles.mark(area);
+			mTextureCache->invalidate(area);
+		}
+	}
+
+	BoundingBox BatchRenderer::getDrawnArea(const PolygonVertex* vertices, U32 numVertices) const
+	{
+		BoundingBox box = { vertices[0].vertex.x, vertices[0].vertex.y, vertices[0].vertex.x, vertices[0].vertex.y };
+		for (U32 i = 1; i < numVertices; i++) {
+			box.MinX = std::min<I32>(box.MinX, vertices[i].vertex.x);
+			box.MinY = std::min<I32>(box.MinY, vertices[i].vertex.y);
+			box.MaxX = std::max<I32>(box.MaxX, vertices[i].vertex.x);
+			box.MaxY = std::max<I32>(box.MaxY, vertices[i].vertex.y);
+		}
+
+		box.MinX = std::max<I32>(box.MinX, vertices[0].drawTopLeft.u);
+		box.MinY = std::max<I32>(box.MinY, vertices[0].drawTopLeft.v);
+		box.MaxX = std::min<I32>(box.MaxX, vertices[0].drawBottomRight.u);
+		box.MaxY = std::min<I32>(box.MaxY, vertices[0].drawBottomRight.v);
+
+		return box;
+	}
+
+	BoundingBox BatchRenderer::getTextureFootprint(const PolygonVertex* vertices, U32 numVertices)
+	{
+		BoundingBox box = { vertices[0].uv.u, vertices[0].uv.v, vertices[0].uv.u, vertices[0].uv.v };
+		for (U32 i = 1; i < numVertices; i++) {
+			box.MinX = std::min<I32>(box.MinX, vertices[i].uv.u);
+			box.MinY = std::min<I32>(box.MinY, vertices[i].uv.v);
+			box.MaxX = std::max<I32>(box.MaxX, vertices[i].uv.u);
+			box.MaxY = std::max<I32>(box.MaxY, vertices[i].uv.v);
+		}
+
+		U8 bpp = vertices[0].bpp;
+		U8 shift = (bpp == 4) ? 2 : (bpp == 8) ? 1 : 0;
+		box.MinX >>= shift;
+		box.MaxX >>= shift;
+
+		if (bpp != 16) {
+			const UV& clut = vertices[0].clutUV;
+			box.MinX = std::min<I32>(box.MinX, clut.u);
+			box.MinY = std::min<I32>(box.MinY, clut.v);
+			box.MaxX = std::max<I32>(box.MaxX, clut.u + (bpp == 4 ? 15 : 255));
+			box.MaxY = std::max<I32>(box.MaxY, clut.v);
+		}
+
+		return box;
 	}
 
 	void BatchRenderer::DrawLineStrip(Vector<PolygonVertex>& vertices)
 	{
-		for (PolygonVertex& vertex : vertices) {
+		drawLineStrip(vertices.data(), (U32)vertices.size());
+	}
+
+	void BatchRenderer::drawLineStrip(PolygonVertex* vertices, U32 numVertices)
+	{
+		for (U32 i = 0; i < numVertices; i++) {
+			PolygonVertex& vertex = vertices[i];
 			vertex.vertex.x += mDrawOffset.x;
 			vertex.vertex.y += mDrawOffset.y;
+			applyDrawState(vertex);
+		}
+
+		BoundingBox drawnArea = getDrawnArea(vertices, numVertices);
+		if (!mSkipRendering && !mSkippedBatches.empty() && (mSkippedTiles.test(drawnArea) || mSkippedSourceTiles.test(drawnArea))) {
+			drawSkippedBatches();
 		}
 
+		//Blending and mask tests read the framebuffer, anything queued below has to land first
 		ptrdiff_t numIndices = std::distance(mLineStripVerticesBase.begin(), mLineStripCurrentVertex);
-		if ((numIndices + vertices.size()) >= MAX_LINE_STRIP_VERTICES || (numIndices > 0 && vertices.at(0).semiTransparency != 255)) {
+		if ((numIndices + numVertices) >= MAX_LINE_STRIP_VERTICES || ((vertices[0].semiTransparency != 255 || vertices[0].checkMask) && mDrawnTiles.test(drawnArea))) {
 			FlushVRAMWrites();
 			Flush();
 			Begin();
 		}
 
-		for (U64 i = 0; i < vertices.size(); i++) {
+		for (U64 i = 0; i < numVertices; i++) {
 			const PolygonVertex& vertex = vertices[i];
 
 			*mLineStripCurrentIndex = std::distance(mLineStripVerticesBase.begin(), mLineStripCurrentVertex);
@@ -314,71 +606,152 @@ namespace esx {
 		*mLineStripCurrentIndex = -1;
 		mLineStripCurrentIndex++;
 		mLineStripCurrentVertex++;
+
+		if (!drawnArea.empty()) {
+			mLineTiles.mark(drawnArea);
+		}
+		markDrawnArea(drawnArea);
 	}
 
 	void BatchRenderer::VRAMWrite(U16 x, U16 y, U32 width, U32 height, const Vector<VRAMColor>& pixels)
 	{
-		Flush();
-		Begin();
+		if (hasPendingDraws()) {
+			FlushVRAMWrites();
+			Flush();
+			Begin();
+		}
 
-		if (mRefreshVRAMData) {
-			refresh16BitData();
-			mRefreshVRAMData = ESX_FALSE;
+		VRAMRect rect = { x, y, width, height };
+
+		if (!mCheckMask) {
+			forEachWrappedRect(rect, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+				pruneSkippedBatches(BoundingBox{ (I32)x, (I32)y, (I32)(x + w - 1), (I32)(y + h - 1) });
+			});
 		}
+		resolveSkipped(rect, ESX_TRUE);
 
-		for (I32 yOff = 0; yOff < height; yOff++) {
-			for (I32 xOff = 0; xOff < width; xOff++) {
-				U16 xImage = x + xOff;
-				U16 yImage = (511 - y - yOff);
+		if (mCheckMask) {
+			VRAMRead(x, y, width, height, mMaskPixels);
+		}
+
+		for (U32 yOff = 0; yOff < height; yOff++) {
+			U16 yImage = (511 - y - yOff) & 511;
+			VRAMColor* row = &mVRAM16[yImage * 1024];
+			const VRAMColor* source = &pixels[yOff * width];
+
+			if (!mCheckMask && !mForceAlpha) {
+				U32 firstSpan = std::min<U32>(width, 1024 - x);
+				std::memcpy(&row[x], source, firstSpan * sizeof(VRAMColor));
+				std::memcpy(&row[0], source + firstSpan, (width - firstSpan) * sizeof(VRAMColor));
+				continue;
+			}
 
-				xImage &= 1023;
-				yImage &= 511;
+			for (U32 xOff = 0; xOff < width; xOff++) {
+				U16 xImage = (x + xOff) & 1023;
 
-				VRAMColor color = pixels.at(yOff * width + xOff);
+				VRAMColor color = source[xOff];
 
-				if (mCheckMask && (mVRAM16[yImage * 1024 + xImage].data & 0x8000) == 0x8000) continue;
-				if (mForceAlpha) color.data |= 0x8000;
+				if (mCheckMask) {
+					const VRAMColor& previous = mMaskPixels[yOff * width + xOff];
+					if ((previous.data & 0x8000) == 0x8000) color = previous;
+					else if (mForceAlpha) color.data |= 0x8000;
+				} else if (mForceAlpha) {
+					color.data |= 0x8000;
+				}
 
-				mVRAM16[yImage * 1024 + xImage] = color;
+				row[xImage] = color;
 			}
 		}
 
+		mPendingVRAMWrites.emplace_back(rect);
+		forEachWrappedRect(rect, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+			mTextureCache->invalidate(BoundingBox{ (I32)x, (I32)y, (I32)(x + w - 1), (I32)(y + h - 1) });
+		});
 		mVRAMWritePending = ESX_TRUE;
 	}
 
 	void BatchRenderer::VRAMRead(U16 x, U16 y, U32 width, U32 height, Vector<VRAMColor>& pixels)
 	{
+		VRAMRect rect = { x, y, width, height };
+
+		if (mReadbackFence == nullptr || mReadbackRect != rect) {
+			FlushVRAMWrites();
+			Flush();
+			Begin();
+
+			resolveSkipped(rect, ESX_FALSE);
+			beginVRAMRead(rect);
+		}
+
+		endVRAMRead(pixels);
+	}
+
+	void BatchRenderer::RequestVRAMRead(U16 x, U16 y, U32 width, U32 height)
+	{
+		FlushVRAMWrites();
 		Flush();
 		Begin();
 
-		if (mRefreshVRAMData) {
-			refresh16BitData();
-			mRefreshVRAMData = ESX_FALSE;
+		VRAMRect rect = { x, y, width, height };
+		resolveSkipped(rect, ESX_FALSE);
+		beginVRAMRead(rect);
+	}
+
+	void BatchRenderer::VRAMCopy(U16 srcX, U16 srcY, U16 dstX, U16 dstY, U32 width, U32 height)
+	{
+		if (mCheckMask || mForceAlpha) {
+			//Mask bits are tested and set per pixel, go through the host copy
+			mCopyPixels.clear();
+			VRAMRead(srcX, srcY, width, height, mCopyPixels);
+			VRAMWrite(dstX, dstY, width, height, mCopyPixels);
+			return;
 		}
 
-		for (I32 yOff = 0; yOff < height; yOff++) {
-			for (I32 xOff = 0; xOff < width; xOff++) {
-				U16 xImage = x + xOff;
-				U16 yImage = (511 - y - yOff);
+		FlushVRAMWrites();
+		Flush();
+		Begin();
+
+		VRAMRect destination = { dstX, dstY, width, height };
+		resolveSkipped(VRAMRect{ srcX, srcY, width, height }, ESX_FALSE);
+		forEachWrappedRect(destination, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+			pruneSkippedBatches(BoundingBox{ (I32)x, (I32)y, (I32)(x + w - 1), (I32)(y + h - 1) });
+		});
+		resolveSkipped(destination, ESX_TRUE);
 
-				xImage &= 1023;
-				yImage &= 511;
+		//Source and destination may overlap, stage the rectangle in a scratch texture first
+		forEachWrappedRect(VRAMRect{ srcX, srcY, width, height }, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+			mTexture16->copyPixels(x, toTextureY(y, h), mTextureCopy, localX, toTextureY(localY, h), w, h);
+		});
 
-				U64 index = (yImage * 1024) + xImage;
+		forEachWrappedRect(destination, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+			mTextureCopy->copyPixels(localX, toTextureY(localY, h), mTexture16, x, toTextureY(y, h), w, h);
+			mTextureCache->invalidate(BoundingBox{ (I32)x, (I32)y, (I32)(x + w - 1), (I32)(y + h - 1) });
+		});
 
-				pixels.emplace_back(mVRAM16.at(index));
-			}
-		}
+		mRefreshVRAMData = ESX_TRUE;
+		mVRAMWritePending = ESX_TRUE;
+	}
+
+	void BatchRenderer::ResolveArea(U16 x, U16 y, U32 width, U32 height)
+	{
+		resolveSkipped(VRAMRect{ x, y, width, height }, ESX_FALSE);
 	}
 
 	void BatchRenderer::Reset()
 	{
 		std::fill(mTriVerticesBase.begin(), mTriVerticesBase.end(), PolygonVertex());
 		mTriCurrentVertex = mTriVerticesBase.begin();
+		mTriangleGrid.clear();
 
 		std::fill(mLineStripIndicesBase.begin(), mLineStripIndicesBase.end(), 0);
 		mLineStripCurrentIndex = mLineStripIndicesBase.begin();
 
+		mSkipRendering = ESX_FALSE;
+		mSkippedBatches.clear();
+		mSkippedVertices = 0;
+		mSkippedTiles.clear();
+		mSkippedSourceTiles.clear();
+
 		mFBO16->bind();
 		glScissor(0, 0, 1024, 512);
 		glClearColor(0, 0, 0, 1);
@@ -387,6 +760,13 @@ namespace esx {
 
 		mVRAM16.resize(1024 * 512);
 		std::fill(mVRAM16.begin(), mVRAM16.end(), VRAMColor());
+		mPendingVRAMWrites.clear();
+		mTextureCache->invalidateAll();
+
+		if (mReadbackFence) {
+			glDeleteSync(mReadbackFence);
+			mReadbackFence = nullptr;
+		}
 
 		mDrawTopLeft = glm::uvec2(0, 0);
 		mDrawBottomRight = glm::uvec2(640, 240);
@@ -401,8 +781,6 @@ namespace esx {
 
 	void BatchRenderer::refresh16BitData()
 	{
-		FlushVRAMWrites();
-
 		void* data = mVRAM16.data();
 		mTexture16->bind();
 		mTexture16->getPixels(&data);
@@ -424,24 +802,107 @@ namespace esx {
 		mTexture24->unbind();
 		glFlush();*/
 
+		if (mRefreshVRAMData) {
+			refresh16BitData();
+			mRefreshVRAMData = ESX_FALSE;
+		}
+
 		mTexture24->bind();
 		mTexture24->setPixels(0, 0, 682, 512, mVRAM16.data());
 		mTexture24->unbind();
 	}
 
+	void BatchRenderer::beginVRAMRead(const VRAMRect& rect)
+	{
+		if (mReadbackFence) {
+			glDeleteSync(mReadbackFence);
+		}
+
+		mReadbackRect = rect;
+
+		//Rows are packed bottom-up in texture order, endVRAMRead flips them back
+		mPBO16Down->bind();
+		forEachWrappedRect(rect, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+			size_t offset = ((rect.Height - localY - h) * rect.Width + localX) * sizeof(VRAMColor);
+			mTexture16->getPixels(x, toTextureY(y, h), w, h, rect.Width, reinterpret_cast<void*>(offset), (1024 * 512 * sizeof(VRAMColor)) - offset);
+		});
+		mPBO16Down->unbind();
+
+		mReadbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void BatchRenderer::endVRAMRead(Vector<VRAMColor>& pixels)
+	{
+		GLenum result = glClientWaitSync(mReadbackFence, GL_SYNC_FLUSH_COMMANDS_BIT, READBACK_TIMEOUT);
+		glDeleteSync(mReadbackFence);
+		mReadbackFence = nullptr;
+
+		U32 width = mReadbackRect.Width;
+		U32 height = mReadbackRect.Height;
+		pixels.resize(width * height);
+
+		//A fence that never signals must not hang emulation, fall back to reading the whole texture
+		if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+			ESX_CORE_LOG_WARNING("BatchRenderer - VRAM readback fence {}, reading synchronously", result == GL_WAIT_FAILED ? "failed" : "timed out");
+
+			FlushVRAMWrites();
+			refresh16BitData();
+			mRefreshVRAMData = ESX_FALSE;
+
+			for (U32 row = 0; row < height; row++) {
+				const VRAMColor* source = &mVRAM16[(511 - ((mReadbackRect.Y + row) & 511)) * 1024];
+				for (U32 column = 0; column < width; column++) {
+					pixels[row * width + column] = source[(mReadbackRect.X + column) & 1023];
+				}
+			}
+			return;
+		}
+
+		mPBO16Down->bind();
+		const VRAMColor* data = reinterpret_cast<const VRAMColor*>(mPBO16Down->mapBufferRange());
+		if (data) {
+			for (U32 row = 0; row < height; row++) {
+				std::memcpy(&pixels[row * width], &data[(height - 1 - row) * width], width * sizeof(VRAMColor));
+			}
+			mPBO16Down->unmapBuffer();
+		}
+		mPBO16Down->unbind();
+	}
+
+	BIT BatchRenderer::hasPendingDraws() const
+	{
+		return mTriCurrentVertex != mTriVerticesBase.begin() || mLineStripCurrentVertex != mLineStripVerticesBase.begin();
+	}
+
+	void BatchRenderer::forEachWrappedRect(const VRAMRect& rect, const Function<void(U32 x, U32 y, U32 localX, U32 localY, U32 width, U32 height)>& function)
+	{
+		U32 firstWidth = std::min<U32>(rect.Width, 1024 - rect.X);
+		U32 firstHeight = std::min<U32>(rect.Height, 512 - rect.Y);
+
+		function(rect.X, rect.Y, 0, 0, firstWidth, firstHeight);
+		if (firstWidth < rect.Width) {
+			function(0, rect.Y, firstWidth, 0, rect.Width - firstWidth, firstHeight);
+		}
+		if (firstHeight < rect.Height) {
+			function(rect.X, 0, 0, firstHeight, firstWidth, rect.Height - firstHeight);
+			if (firstWidth < rect.Width) {
+				function(0, 0, firstWidth, firstHeight, rect.Width - firstWidth, rect.Height - firstHeight);
+			}
+		}
+	}
+
 	void BatchRenderer::FlushVRAMWrites()
 	{
 		if (mVRAMWritePending) {
 			mTexture16->bind();
-			mPBO16Up->bind();
-			VRAMColor* dma16 = reinterpret_cast<VRAMColor*>(mPBO16Up->mapBuffer());
-			if (dma16) {
-				std::memcpy(dma16, mVRAM16.data(), mVRAM16.size() * sizeof(VRAMColor));
-				mPBO16Up->unmapBuffer();
-				mTexture16->copy(mPBO16Up);
+			for (const VRAMRect& rect : mPendingVRAMWrites) {
+				forEachWrappedRect(rect, [&](U32 x, U32 y, U32 localX, U32 localY, U32 w, U32 h) {
+					U32 textureY = toTextureY(y, h);
+					mTexture16->setPixels(x, textureY, w, h, 1024, &mVRAM16[textureY * 1024 + x]);
+				});
 			}
-			mPBO16Up->unbind();
 			mTexture16->unbind();
+			mPendingVRAMWrites.clear();
 
 			if (m24Bit) {
 				refresh24BitTexture();
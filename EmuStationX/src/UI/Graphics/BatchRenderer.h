@@ -9,11 +9,25 @@
 #include "UI/Graphics/PixelBuffer.h"
 #include "UI/Graphics/Texture2D.h"
 #include "UI/Graphics/FrameBuffer.h"
+#include "UI/Graphics/TextureCache.h"
+
+#include "Utils/Geometry.h"
 
 #include <glm/glm.hpp>
 
+struct __GLsync;
+
 namespace esx {
 
+	struct VRAMRect {
+		U16 X = 0;
+		U16 Y = 0;
+		U32 Width = 0;
+		U32 Height = 0;
+
+		BIT operator==(const VRAMRect& other) const = default;
+	};
+
 	class BatchRenderer : public IRenderer {
 	public:
 		BatchRenderer();
@@ -30,19 +44,54 @@ namespace esx {
 		void SetForceAlpha(BIT value) override;
 		void SetCheckMask(BIT value) override;
 		virtual void SetDisplayMode24(BIT value) override;
+		void SetSkipRendering(BIT value) override;
 		void Clear(U16 x, U16 y, U16 w, U16 h, Color& color) override;
 		void DrawPolygon(Array<PolygonVertex,4>& vertices, U32 numVertices) override;
 		void DrawLineStrip(Vector<PolygonVertex>& vertices) override;
+		void Submit(PrimitiveBatch& batch) override;
 		void VRAMWrite(U16 x, U16 y, U32 width, U32 height, const Vector<VRAMColor>& pixels) override;
 		void VRAMRead(U16 x, U16 y, U32 width, U32 height, Vector<VRAMColor>& pixels) override;
+		void RequestVRAMRead(U16 x, U16 y, U32 width, U32 height) override;
+		void VRAMCopy(U16 srcX, U16 srcY, U16 dstX, U16 dstY, U32 width, U32 height) override;
+		void ResolveArea(U16 x, U16 y, U32 width, U32 height) override;
 
 		const SharedPtr<FrameBuffer>& getPreviousFrame() { return m24Bit ? mFBO24 : mFBO16; }
 
+		void setTextureCacheEnabled(BIT value) { mTextureCacheEnabled = value; }
+		BIT isTextureCacheEnabled() const { return mTextureCacheEnabled; }
+
 		virtual void Reset() override;
 
 	private:
+		//Batches of skipped frames are kept as they were queued, they only reach the framebuffer once something depends on them
+		struct SkippedBatch {
+			Vector<PolygonVertex> Triangles = {};
+			Vector<PolygonVertex> LineVertices = {};
+			Vector<U32> LineIndices = {};
+		};
+
+		void rasterize(const PolygonVertex* triangles, size_t numTriIndices, const PolygonVertex* lineVertices, const U32* lineIndices, size_t numLineStripIndices);
+		void deferBatch();
+		void drawSkippedBatches();
+		void pruneSkippedBatches(const BoundingBox& area);
+		void markSkippedBatch(const SkippedBatch& batch);
+		void resolveSkipped(const VRAMRect& rect, BIT written);
 		void refresh16BitData();
 		void refresh24BitTexture();
+		void drawPolygon(const PolygonVertex* vertices, U32 numVertices);
+		void drawLineStrip(PolygonVertex* vertices, U32 numVertices);
+		void pushPolygon(Array<PolygonVertex, 4>& vertices, U32 numVertices);
+		void applyDrawState(PolygonVertex& vertex) const;
+		void applyTextureCache(Array<PolygonVertex, 4>& vertices, U32 numVertices);
+		void markDrawnArea(const BoundingBox& area);
+		BoundingBox getDrawnArea(const PolygonVertex* vertices, U32 numVertices) const;
+		static BoundingBox getTextureFootprint(const PolygonVertex* vertices, U32 numVertices);
+		void beginVRAMRead(const VRAMRect& rect);
+		void endVRAMRead(Vector<VRAMColor>& pixels);
+		BIT hasPendingDraws() const;
+
+		static void forEachWrappedRect(const VRAMRect& rect, const Function<void(U32 x, U32 y, U32 localX, U32 localY, U32 width, U32 height)>& function);
+		static U32 toTextureY(U32 y, U32 height) { return 512 - y - height; }
 
 	public:
 		static const size_t QUAD_VERTEX_SIZE = sizeof(PolygonVertex);
@@ -54,6 +103,10 @@ namespace esx {
 		static const size_t LINE_STRIP_VERTEX_SIZE = sizeof(PolygonVertex);
 		static const size_t MAX_LINE_STRIP_VERTICES = 10000;
 		static const size_t LINE_STRIP_BUFFER_SIZE = LINE_STRIP_VERTEX_SIZE * MAX_LINE_STRIP_VERTICES;
+
+		static const size_t MAX_SKIPPED_VERTICES = TRI_MAX_VERTICES * 8;
+
+		static const U64 READBACK_TIMEOUT = 1000000000;
 	private:
 		SharedPtr<Shader> mShader;
 
@@ -62,6 +115,8 @@ namespace esx {
 		SharedPtr<VertexBuffer> mTriVBO;
 		Vector<PolygonVertex> mTriVerticesBase;
 		Vector<PolygonVertex>::iterator mTriCurrentVertex;
+		TriangleGrid mTriangleGrid;
+		TileMask mDrawnTiles;
 
 		SharedPtr<VertexArray> mLineStripVAO;
 		SharedPtr<VertexBuffer> mLineStripVBO;
@@ -70,7 +125,13 @@ namespace esx {
 		Vector<PolygonVertex>::iterator mLineStripCurrentVertex;
 		Vector<U32> mLineStripIndicesBase;
 		Vector<U32>::iterator mLineStripCurrentIndex;
+		TileMask mLineTiles;
 
+		BIT mSkipRendering = ESX_FALSE;
+		Vector<SkippedBatch> mSkippedBatches;
+		size_t mSkippedVertices = 0;
+		TileMask mSkippedTiles;
+		TileMask mSkippedSourceTiles;
 
 		SharedPtr<FrameBuffer> mFBO16;
 		SharedPtr<Texture2D> mTexture16;
@@ -78,6 +139,12 @@ namespace esx {
 		SharedPtr<FrameBuffer> mFBO24;
 		SharedPtr<Texture2D> mTexture24;
 
+		SharedPtr<Texture2D> mTextureCopy;
+
+		SharedPtr<TextureCache> mTextureCache;
+		BIT mTextureCacheEnabled = ESX_FALSE;
+		U64 mBatchCounter = 0;
+
 		glm::ivec2 mDrawOffset = glm::ivec2(0,0);
 		glm::uvec2 mDrawTopLeft = glm::uvec2(0,0);
 		glm::uvec2 mDrawBottomRight = glm::uvec2(0,0);
@@ -85,13 +152,19 @@ namespace esx {
 		BIT mCheckMask = ESX_FALSE;
 
 		Vector<VRAMColor> mVRAM16;
+		Vector<VRAMColor> mMaskPixels;
+		Vector<VRAMColor> mCopyPixels;
 		BIT mRefreshVRAMData = ESX_FALSE;
 		BIT mVRAMWritePending = ESX_FALSE;
+		Vector<VRAMRect> mPendingVRAMWrites;
+
+		VRAMRect mReadbackRect = {};
+		__GLsync* mReadbackFence = nullptr;
 
 		BIT m24Bit = ESX_FALSE;
 
 		//SharedPtr<PixelBuffer> mPBO24Up;
-		SharedPtr<PixelBuffer> mPBO16Up;
+		SharedPtr<PixelBuffer> mPBO16Down;
 	};
 
 }
\ No newline at end of file
@@ -24,10 +24,19 @@ namespace esx {
 		return result;
 	}
 
-	PixelBuffer::PixelBuffer()
+	static GLenum fromTarget(PixelBufferTarget target) {
+		switch (target) {
+			case PixelBufferTarget::Unpack: return GL_PIXEL_UNPACK_BUFFER;
+			case PixelBufferTarget::Pack: return GL_PIXEL_PACK_BUFFER;
+		}
+		return 0;
+	}
+
+	PixelBuffer::PixelBuffer(PixelBufferTarget target)
+		: mTarget(target)
 	{
 		glGenBuffers(1, &mRendererID);
-		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mRendererID);
+		glBindBuffer(fromTarget(mTarget), mRendererID);
 	}
 
 	PixelBuffer::~PixelBuffer()
@@ -37,34 +46,34 @@ namespace esx {
 
 	void PixelBuffer::bind()
 	{
-		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mRendererID);
+		glBindBuffer(fromTarget(mTarget), mRendererID);
 	}
 
 	void PixelBuffer::unbind()
 	{
-		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glBindBuffer(fromTarget(mTarget), 0);
 	}
 
 	void PixelBuffer::setData(void* data, size_t size, U32 flags)
 	{
-		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, data, GL_STREAM_DRAW);
+		glBufferData(fromTarget(mTarget), size, data, mTarget == PixelBufferTarget::Pack ? GL_STREAM_READ : GL_STREAM_DRAW);
 		mSize = size;
 		mFlags = flags;
 	}
 
 	void* PixelBuffer::mapBuffer()
 	{
-		return glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+		return glMapBuffer(fromTarget(mTarget), mTarget == PixelBufferTarget::Pack ? GL_READ_ONLY : GL_WRITE_ONLY);
 	}
 
 	void* PixelBuffer::mapBufferRange()
 	{
-		return glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, mSize, fromFlagsToBitField(mFlags));
+		return glMapBufferRange(fromTarget(mTarget), 0, mSize, fromFlagsToBitField(mFlags));
 	}
 
 	void PixelBuffer::unmapBuffer()
 	{
-		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glUnmapBuffer(fromTarget(mTarget));
 	}
 
 }
\ No newline at end of file
@@ -10,9 +10,14 @@ namespace esx {
 		Read = 1 << 2
 	};
 
+	enum class PixelBufferTarget {
+		Unpack,
+		Pack
+	};
+
 	class PixelBuffer {
 	public:
-		PixelBuffer();
+		PixelBuffer(PixelBufferTarget target = PixelBufferTarget::Unpack);
 		~PixelBuffer();
 
 		void bind();
@@ -26,6 +31,7 @@ namespace esx {
 		U32 mRendererID = 0;
 		size_t mSize = 0;
 		U32 mFlags = 0;
+		PixelBufferTarget mTarget = PixelBufferTarget::Unpack;
 	};
 
 }
\ No newline at end of file
@@ -114,6 +114,29 @@ namespace esx {
 		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, fromDataFormat(mDataFormat), fromDataType(mDataType), pixelData);
 	}
 
+	void Texture2D::setPixels(U32 x, U32 y, U32 width, U32 height, U32 rowLength, const void* pixelData)
+	{
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, fromDataFormat(mDataFormat), fromDataType(mDataType), pixelData);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	}
+
+	void Texture2D::getPixels(U32 x, U32 y, U32 width, U32 height, U32 rowLength, void* pixels, size_t size)
+	{
+		glPixelStorei(GL_PACK_ROW_LENGTH, rowLength);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTextureSubImage(mRendererID, 0, x, y, 0, width, height, 1, fromDataFormat(mDataFormat), fromDataType(mDataType), (GLsizei)size, pixels);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+	}
+
+	void Texture2D::copyPixels(U32 srcX, U32 srcY, const SharedPtr<Texture2D>& destination, U32 dstX, U32 dstY, U32 width, U32 height)
+	{
+		glCopyImageSubData(mRendererID, GL_TEXTURE_2D, 0, srcX, srcY, 0, destination->mRendererID, GL_TEXTURE_2D, 0, dstX, dstY, 0, width, height, 1);
+	}
+
 	void Texture2D::getPixel(U32 x, U32 y, void** pixelData)
 	{
 		glGetTexImage(GL_TEXTURE_2D, 0, fromDataFormat(mDataFormat), fromDataType(mDataType), *pixelData);
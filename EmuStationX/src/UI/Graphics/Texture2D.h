@@ -40,6 +40,9 @@ namespace esx {
 		void updatePixels(void* pixels);
 		void setPixel(U32 x,U32 y, const void* pixelData);
 		void setPixels(U32 x, U32 y, U32 width, U32 height, const void* pixelData);
+		void setPixels(U32 x, U32 y, U32 width, U32 height, U32 rowLength, const void* pixelData);
+		void getPixels(U32 x, U32 y, U32 width, U32 height, U32 rowLength, void* pixels, size_t size);
+		void copyPixels(U32 srcX, U32 srcY, const SharedPtr<Texture2D>& destination, U32 dstX, U32 dstY, U32 width, U32 height);
 		void getPixel(U32 x, U32 y, void** pixelData);
 		SharedPtr<Texture2D> createView(InternalFormat viewFormat);
 
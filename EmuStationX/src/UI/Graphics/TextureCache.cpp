@@ -0,0 +1,131 @@
+#include "UI/Graphics/TextureCache.h"
+
+#include <glad/glad.h>
+
+namespace esx {
+
+	TextureCache::TextureCache()
+	{
+		mAtlas = MakeShared<Texture2D>(3);
+		mAtlas->setData(nullptr, ATLAS_SIZE, ATLAS_SIZE, InternalFormat::RGB5_A1, DataType::UnsignedShort1_555, DataFormat::RGBA);
+
+		mFBO = MakeShared<FrameBuffer>(ATLAS_SIZE, ATLAS_SIZE);
+		mFBO->setColorAttachment(mAtlas);
+		mFBO->init();
+		mAtlas->unbind();
+
+		//The decode pass has no vertex data but core profile still wants a vertex array bound
+		mVAO = MakeShared<VertexArray>();
+		mVAO->unbind();
+
+		mDecodeShader = Shader::LoadFromFile("commons/shaders/texpage.vert", "commons/shaders/texpage.frag");
+	}
+
+	I32 TextureCache::find(const TexturePageKey& key)
+	{
+		for (U32 slot = 0; slot < NUM_SLOTS; slot++) {
+			const TexturePageEntry& entry = mEntries[slot];
+			if (entry.Valid && entry.Key == key) {
+				return slot;
+			}
+		}
+		return -1;
+	}
+
+	U32 TextureCache::getVictim() const
+	{
+		//Invalid slots first, then the least recently used page
+		U32 victim = 0;
+		for (U32 slot = 1; slot < NUM_SLOTS; slot++) {
+			const TexturePageEntry& entry = mEntries[slot];
+			const TexturePageEntry& current = mEntries[victim];
+			if (entry.Valid != current.Valid) {
+				if (!entry.Valid) victim = slot;
+			} else if (entry.LastUse < current.LastUse) {
+				victim = slot;
+			}
+		}
+		return victim;
+	}
+
+	void TextureCache::decode(U32 slot, const TexturePageKey& key, const SharedPtr<Texture2D>& vram)
+	{
+		TexturePageEntry& entry = mEntries[slot];
+		entry.Key = key;
+		entry.Valid = ESX_TRUE;
+
+		I32 texelsPerPixel = 16 / key.BPP;
+		I32 pageX = key.PageX / texelsPerPixel;
+		entry.PageArea = { pageX, key.PageY, pageX + (I32)(SLOT_SIZE / texelsPerPixel) - 1, key.PageY + (I32)SLOT_SIZE - 1 };
+		entry.ClutArea = { key.ClutX, key.ClutY, key.ClutX + (key.BPP == 4 ? 15 : 255), key.ClutY };
+
+		UV origin = getSlotOrigin(slot);
+
+		mFBO->bind();
+		glViewport(origin.u, origin.v, SLOT_SIZE, SLOT_SIZE);
+		glScissor(origin.u, origin.v, SLOT_SIZE, SLOT_SIZE);
+
+		mDecodeShader->start();
+		mDecodeShader->uploadUniform("uPage", glm::ivec2(key.PageX, key.PageY));
+		mDecodeShader->uploadUniform("uClut", glm::ivec2(key.ClutX, key.ClutY));
+		mDecodeShader->uploadUniform("uBPP", (int)key.BPP);
+		mDecodeShader->uploadUniform("uSlot", glm::ivec2(origin.u, origin.v));
+
+		vram->bind();
+		mVAO->bind();
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		mVAO->unbind();
+		vram->unbind();
+
+		mDecodeShader->stop();
+
+		//FrameBuffer::unbind blits to the window, the atlas is never presented
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void TextureCache::use(U32 slot, U64 batch)
+	{
+		TexturePageEntry& entry = mEntries[slot];
+		entry.LastUse = ++mUseCounter;
+		entry.LastBatch = batch;
+	}
+
+	void TextureCache::invalidate(const BoundingBox& area)
+	{
+		for (TexturePageEntry& entry : mEntries) {
+			if (entry.Valid && (entry.PageArea.overlaps(area) || entry.ClutArea.overlaps(area))) {
+				entry.Valid = ESX_FALSE;
+			}
+		}
+	}
+
+	void TextureCache::invalidateAll()
+	{
+		for (TexturePageEntry& entry : mEntries) {
+			entry.Valid = ESX_FALSE;
+		}
+	}
+
+	void TextureCache::bind()
+	{
+		mAtlas->bind();
+	}
+
+	void TextureCache::unbind()
+	{
+		mAtlas->unbind();
+	}
+
+	TexturePageKey TextureCache::GetKey(const PolygonVertex& vertex)
+	{
+		TexturePageKey key = {};
+		key.PageX = vertex.texPage.u;
+		key.PageY = vertex.texPage.v;
+		key.ClutX = vertex.clutUV.u;
+		key.ClutY = vertex.clutUV.v;
+		key.BPP = vertex.bpp;
+
+		return key;
+	}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Base/Base.h"
+#include "Core/IRenderer.h"
+
+#include "UI/Graphics/Shader.h"
+#include "UI/Graphics/VertexArray.h"
+#include "UI/Graphics/Texture2D.h"
+#include "UI/Graphics/FrameBuffer.h"
+
+#include "Utils/Geometry.h"
+
+namespace esx {
+
+	struct TexturePageKey {
+		U16 PageX = 0;
+		U16 PageY = 0;
+		U16 ClutX = 0;
+		U16 ClutY = 0;
+		U8 BPP = 0;
+
+		BIT operator==(const TexturePageKey& other) const = default;
+	};
+
+	struct TexturePageEntry {
+		TexturePageKey Key = {};
+		BIT Valid = ESX_FALSE;
+		U64 LastUse = 0;
+		U64 LastBatch = 0;
+		BoundingBox PageArea = {};
+		BoundingBox ClutArea = {};
+	};
+
+	//4/8-bit texture pages decoded through their CLUT into 256x256 slots of a RGB5_A1 atlas
+	class TextureCache {
+	public:
+		TextureCache();
+		~TextureCache() = default;
+
+		I32 find(const TexturePageKey& key);
+		U32 getVictim() const;
+		void decode(U32 slot, const TexturePageKey& key, const SharedPtr<Texture2D>& vram);
+		void use(U32 slot, U64 batch);
+		void invalidate(const BoundingBox& area);
+		void invalidateAll();
+
+		const TexturePageEntry& getEntry(U32 slot) const { return mEntries[slot]; }
+		UV getSlotOrigin(U32 slot) const { return UV((slot % SLOTS_PER_ROW) * SLOT_SIZE, (slot / SLOTS_PER_ROW) * SLOT_SIZE); }
+
+		void bind();
+		void unbind();
+
+		static TexturePageKey GetKey(const PolygonVertex& vertex);
+
+	public:
+		static constexpr U32 SLOT_SIZE = 256;
+		static constexpr U32 ATLAS_SIZE = 2048;
+		static constexpr U32 SLOTS_PER_ROW = ATLAS_SIZE / SLOT_SIZE;
+		static constexpr U32 NUM_SLOTS = SLOTS_PER_ROW * SLOTS_PER_ROW;
+
+	private:
+		Array<TexturePageEntry, NUM_SLOTS> mEntries = {};
+		U64 mUseCounter = 0;
+
+		SharedPtr<Texture2D> mAtlas;
+		SharedPtr<FrameBuffer> mFBO;
+		SharedPtr<VertexArray> mVAO;
+		SharedPtr<Shader> mDecodeShader;
+	};
+
+}
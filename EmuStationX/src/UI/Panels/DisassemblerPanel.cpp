@@ -54,35 +54,23 @@ namespace esx {
 			case DebugState::StepOver:
 			case DebugState::Step:
 			case DebugState::Running: {
-				//U64 startClocks = mInstance->getClocks();
-				do {
-					while (mInstance->getClocks() < Scheduler::NextEvent().ClockTarget) {
-						if (breakFunction(mInstance->mPC)) {
-							mScrollToCurrent = true;
-							mCurrent = mInstance->mPC;
-							mNextPC = mInstance->mNextPC;
-							setDebugState(DebugState::Breakpoint);
-							break;
-						}
-
-						mInstance->clock();
-
-						if (mEXE && mInstance->mPC == 0x80030000) {
-							sideLoad();
-						}
-					}
+				//Turbo runs several frames per host update, the GPU only draws the one that gets presented
+				U32 frames = 1;
+				switch (mSpeed) {
+					case EmulationSpeed::Normal: frames = 1; break;
+					case EmulationSpeed::Turbo2x: frames = 2; break;
+					case EmulationSpeed::Turbo4x: frames = 4; break;
+					case EmulationSpeed::Uncapped: frames = UINT32_MAX; break;
+				}
 
-					if (mInstance->getClocks() >= Scheduler::NextEvent().ClockTarget) {
-						Scheduler::ExecuteEvent();
-						Scheduler::Progress();
-					}
+				auto start = std::chrono::steady_clock::now();
+				for (U32 frame = 0; frame < frames; frame++) {
+					if (!runFrame() || mDebugState != DebugState::Running) break;
 
-					if (mDebugState == DebugState::Breakpoint) {
+					if (mSpeed == EmulationSpeed::Uncapped && std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count() >= UNCAPPED_UPDATE_TIME) {
 						break;
 					}
-				} while (!mGPU->isNewFrameAvailable());
-				/*U64 endClocks = mInstance->getClocks();
-				ESX_CORE_LOG_TRACE("{}", endClocks - startClocks);*/
+				}
 
 				break;
 			}
@@ -93,6 +81,53 @@ namespace esx {
 		}
 	}
 
+	BIT DisassemblerPanel::runFrame()
+	{
+		//U64 startClocks = mInstance->getClocks();
+		do {
+			while (mInstance->getClocks() < Scheduler::NextEvent().ClockTarget) {
+				if (breakFunction(mInstance->mPC)) {
+					mScrollToCurrent = true;
+					mCurrent = mInstance->mPC;
+					mNextPC = mInstance->mNextPC;
+					setDebugState(DebugState::Breakpoint);
+					break;
+				}
+
+				mInstance->clock();
+
+				if (mEXE && mInstance->mPC == 0x80030000) {
+					sideLoad();
+				}
+			}
+
+			if (mInstance->getClocks() >= Scheduler::NextEvent().ClockTarget) {
+				Scheduler::ExecuteEvent();
+				Scheduler::Progress();
+			}
+
+			if (mDebugState == DebugState::Breakpoint) {
+				return ESX_FALSE;
+			}
+		} while (!mGPU->isFrameComplete());
+		/*U64 endClocks = mInstance->getClocks();
+		ESX_CORE_LOG_TRACE("{}", endClocks - startClocks);*/
+
+		return ESX_TRUE;
+	}
+
+	void DisassemblerPanel::setSpeed(EmulationSpeed speed)
+	{
+		mSpeed = speed;
+
+		switch (speed) {
+			case EmulationSpeed::Normal: mGPU->setTurbo(1); break;
+			case EmulationSpeed::Turbo2x: mGPU->setTurbo(2); break;
+			case EmulationSpeed::Turbo4x: mGPU->setTurbo(4); break;
+			case EmulationSpeed::Uncapped: mGPU->setTurbo(0); break;
+		}
+	}
+
 	void DisassemblerPanel::loadEXE(const std::filesystem::path& exePath)
 	{
 		mEXE = MakeShared<EXE>(exePath);
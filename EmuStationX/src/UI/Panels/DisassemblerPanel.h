@@ -22,6 +22,13 @@ namespace esx {
 		Stop
 	};
 
+	enum class EmulationSpeed {
+		Normal,
+		Turbo2x,
+		Turbo4x,
+		Uncapped
+	};
+
 	class DisassemblerPanel : public Panel {
 	public:
 		DisassemblerPanel();
@@ -42,6 +49,9 @@ namespace esx {
 
 		DebugState getDebugState() const { return mDebugState; }
 
+		void setSpeed(EmulationSpeed speed);
+		EmulationSpeed getSpeed() const { return mSpeed; }
+
 		void loadEXE(const std::filesystem::path& exePath);
 
 	protected:
@@ -65,6 +75,7 @@ namespace esx {
 		void setDebugState(DebugState debugState) { mPrevDebugState = mDebugState; mDebugState = debugState; }
 
 		void sideLoad();
+		BIT runFrame();
 
 		SharedPtr<R3000> mInstance;
 		SharedPtr<GPU> mGPU;
@@ -81,7 +92,10 @@ namespace esx {
 		uint32_t mCurrent;
 		U32 mNextPC;
 
+		EmulationSpeed mSpeed = EmulationSpeed::Normal;
+
 		static const size_t disassembleRange = 10;
+		static constexpr F64 UNCAPPED_UPDATE_TIME = 1.0 / 70.0;
 
 
 	};
@@ -0,0 +1,132 @@
+#include "AudioCapture.h"
+
+#include "Utils/LoggingSystem.h"
+
+namespace esx {
+
+	AudioCapture::~AudioCapture()
+	{
+		stop();
+	}
+
+	BIT AudioCapture::start(const std::filesystem::path& path, U32 sampleRate)
+	{
+		stop();
+
+		mStream.open(path, std::ios::binary | std::ios::trunc);
+		if (!mStream.is_open()) {
+			ESX_CORE_LOG_ERROR("AudioCapture - Unable to open {}", path.string());
+			return ESX_FALSE;
+		}
+
+		mPath = path;
+		mSampleRate = sampleRate;
+		writeHeader(0);
+
+		mFrames.resize(CAPACITY);
+		mWriteIndex.store(0, std::memory_order_relaxed);
+		mReadIndex.store(0, std::memory_order_relaxed);
+		mQuit.store(ESX_FALSE, std::memory_order_relaxed);
+		mFramesWritten.store(0, std::memory_order_relaxed);
+		mDroppedFrames.store(0, std::memory_order_relaxed);
+		mHash = 0xCBF29CE484222325;
+
+		mWriter = std::thread(&AudioCapture::writerLoop, this);
+		mActive = ESX_TRUE;
+
+		return ESX_TRUE;
+	}
+
+	void AudioCapture::stop()
+	{
+		if (!mActive) return;
+		mActive = ESX_FALSE;
+
+		mQuit.store(ESX_TRUE, std::memory_order_release);
+		mWriter.join();
+
+		U64 frames = getFramesWritten();
+		writeHeader(static_cast<U32>(frames * sizeof(AudioFrame)));
+		mStream.close();
+		mFrames = {};
+
+		ESX_CORE_LOG_INFO("AudioCapture - {} frames written to {}, hash {:016x}", frames, mPath.string(), mHash);
+		if (getDroppedFrames() > 0) {
+			ESX_CORE_LOG_WARNING("AudioCapture - {} frames dropped, the writer could not keep up", getDroppedFrames());
+		}
+	}
+
+	void AudioCapture::push(const AudioFrame& frame)
+	{
+		U32 write = mWriteIndex.load(std::memory_order_relaxed);
+		if (write - mReadIndex.load(std::memory_order_acquire) == CAPACITY) {
+			mDroppedFrames.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		mFrames[write & MASK] = frame;
+		mWriteIndex.store(write + 1, std::memory_order_release);
+	}
+
+	void AudioCapture::writerLoop()
+	{
+		while (ESX_TRUE) {
+			//Read the quit flag first so the frames pushed before it are still drained
+			BIT quit = mQuit.load(std::memory_order_acquire);
+
+			U32 read = mReadIndex.load(std::memory_order_relaxed);
+			U32 write = mWriteIndex.load(std::memory_order_acquire);
+
+			if (read == write) {
+				if (quit) break;
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				continue;
+			}
+
+			//One contiguous run up to the wrap point per pass
+			U32 start = read & MASK;
+			U32 count = std::min(write - read, CAPACITY - start);
+
+			const char* bytes = reinterpret_cast<const char*>(&mFrames[start]);
+			U32 size = count * sizeof(AudioFrame);
+			mStream.write(bytes, size);
+
+			for (U32 i = 0; i < size; i++) {
+				mHash = (mHash ^ static_cast<U8>(bytes[i])) * 0x100000001B3;
+			}
+
+			mReadIndex.store(read + count, std::memory_order_release);
+			mFramesWritten.fetch_add(count, std::memory_order_release);
+		}
+	}
+
+	void AudioCapture::writeHeader(U32 dataSize)
+	{
+		constexpr U16 CHANNELS = 2;
+		constexpr U16 BITS_PER_SAMPLE = 16;
+		constexpr U16 BLOCK_ALIGN = CHANNELS * BITS_PER_SAMPLE / 8;
+
+		auto write = [&](auto value) {
+			mStream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		};
+
+		mStream.seekp(0);
+		mStream.write("RIFF", 4);
+		write(static_cast<U32>(36 + dataSize));
+		mStream.write("WAVE", 4);
+
+		mStream.write("fmt ", 4);
+		write(static_cast<U32>(16));
+		write(static_cast<U16>(1));
+		write(CHANNELS);
+		write(mSampleRate);
+		write(static_cast<U32>(mSampleRate * BLOCK_ALIGN));
+		write(BLOCK_ALIGN);
+		write(BITS_PER_SAMPLE);
+
+		mStream.write("data", 4);
+		write(dataSize);
+		mStream.seekp(0, std::ios::end);
+	}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Base/Base.h"
+#include "Base/CDBase.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace esx {
+
+	//Tees a stream of stereo frames into a 16 bit PCM WAV file.
+	//The emulation thread only pushes into a lock free ring, a writer thread owns the file,
+	//so a slow disk can at worst drop frames but never stalls emulation.
+	class AudioCapture {
+	public:
+		AudioCapture() = default;
+		~AudioCapture();
+
+		BIT start(const std::filesystem::path& path, U32 sampleRate = 44100);
+		void stop();
+		BIT isActive() const { return mActive; }
+
+		//Producer side
+		void push(const AudioFrame& frame);
+
+		U64 getFramesWritten() const { return mFramesWritten.load(std::memory_order_acquire); }
+		U64 getDroppedFrames() const { return mDroppedFrames.load(std::memory_order_acquire); }
+		U64 getHash() const { return mHash; }
+
+	public:
+		static constexpr U32 CAPACITY = 65536;
+
+	private:
+		void writerLoop();
+		void writeHeader(U32 dataSize);
+
+	private:
+		static constexpr U32 MASK = CAPACITY - 1;
+
+		BIT mActive = ESX_FALSE;
+		U32 mSampleRate = 44100;
+		std::filesystem::path mPath = {};
+		std::ofstream mStream = {};
+		std::thread mWriter = {};
+
+		Vector<AudioFrame> mFrames = {};
+		alignas(64) std::atomic<U32> mWriteIndex = 0;
+		alignas(64) std::atomic<U32> mReadIndex = 0;
+		std::atomic<BIT> mQuit = ESX_FALSE;
+
+		std::atomic<U64> mFramesWritten = 0;
+		std::atomic<U64> mDroppedFrames = 0;
+		U64 mHash = 0;
+	};
+
+}
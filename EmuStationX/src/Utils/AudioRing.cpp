@@ -0,0 +1,57 @@
+#include "AudioRing.h"
+
+namespace esx {
+
+	BIT AudioRing::push(const AudioFrame& frame)
+	{
+		U32 write = mWriteIndex.load(std::memory_order_relaxed);
+		if (write - mReadIndex.load(std::memory_order_acquire) == CAPACITY) {
+			return ESX_FALSE;
+		}
+
+		mFrames[write & MASK] = frame;
+		mWriteIndex.store(write + 1, std::memory_order_release);
+
+		return ESX_TRUE;
+	}
+
+	void AudioRing::read(AudioFrame* output, U32 numFrames)
+	{
+		U32 read = mReadIndex.load(std::memory_order_relaxed);
+		U32 write = mWriteIndex.load(std::memory_order_acquire);
+
+		if (mFlush.exchange(ESX_FALSE, std::memory_order_acq_rel)) {
+			read = write;
+			mPosition = 0.0;
+		}
+
+		//Proportional control on the fill level, smoothed so the pitch change is inaudible
+		U32 available = write - read;
+		F64 error = (static_cast<F64>(available) - TARGET_FILL) / TARGET_FILL;
+		F64 targetRatio = 1.0 + std::clamp(error * MAX_RATE_ADJUST, -MAX_RATE_ADJUST, MAX_RATE_ADJUST);
+		mRatio += (targetRatio - mRatio) * 0.1;
+
+		for (U32 i = 0; i < numFrames; i++) {
+			if (write - read < 2) {
+				//Underrun, hold the last frame rather than dropping to silence
+				output[i] = mLast;
+				continue;
+			}
+
+			const AudioFrame& a = mFrames[read & MASK];
+			const AudioFrame& b = mFrames[(read + 1) & MASK];
+			output[i].Left = static_cast<I16>(a.Left + (b.Left - a.Left) * mPosition);
+			output[i].Right = static_cast<I16>(a.Right + (b.Right - a.Right) * mPosition);
+			mLast = output[i];
+
+			mPosition += mRatio;
+			while (mPosition >= 1.0 && write - read >= 2) {
+				mPosition -= 1.0;
+				read++;
+			}
+		}
+
+		mReadIndex.store(read, std::memory_order_release);
+	}
+
+}
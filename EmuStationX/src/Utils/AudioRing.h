@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Base/Base.h"
+#include "Base/CDBase.h"
+
+namespace esx {
+
+	//Single producer single consumer ring of stereo frames between the SPU and the audio device.
+	//The reader resamples by up to MAX_RATE_ADJUST to keep the fill around TARGET_FILL.
+	class AudioRing {
+	public:
+		AudioRing() = default;
+		~AudioRing() = default;
+
+		//Producer side
+		BIT push(const AudioFrame& frame);
+
+		//Consumer side, always writes numFrames frames
+		void read(AudioFrame* output, U32 numFrames);
+
+		void requestFlush() { mFlush.store(ESX_TRUE, std::memory_order_release); }
+
+		U32 size() const { return mWriteIndex.load(std::memory_order_acquire) - mReadIndex.load(std::memory_order_acquire); }
+		F64 getRatio() const { return mRatio; }
+
+	public:
+		static constexpr U32 CAPACITY = 8192;
+		static constexpr U32 TARGET_FILL = 2048;
+		static constexpr F64 MAX_RATE_ADJUST = 0.005;
+
+	private:
+		static constexpr U32 MASK = CAPACITY - 1;
+
+		alignas(64) Array<AudioFrame, CAPACITY> mFrames = {};
+		alignas(64) std::atomic<U32> mWriteIndex = 0;
+		alignas(64) std::atomic<U32> mReadIndex = 0;
+		std::atomic<BIT> mFlush = ESX_FALSE;
+
+		//Owned by the consumer
+		F64 mPosition = 0.0;
+		F64 mRatio = 1.0;
+		AudioFrame mLast = {};
+	};
+
+}
@@ -0,0 +1,159 @@
+#include "BlockCompression.h"
+
+#include <cstring>
+
+namespace esx {
+
+	constexpr U32 MIN_MATCH = 4;
+	constexpr U32 LAST_LITERALS = 5;
+	constexpr U32 MATCH_START_LIMIT = 12;
+	constexpr U32 MAX_OFFSET = 0xFFFF;
+	constexpr U32 HASH_BITS = 12;
+
+	static U32 read32(const U8* pointer)
+	{
+		U32 value;
+		std::memcpy(&value, pointer, sizeof(U32));
+		return value;
+	}
+
+	static U32 hash(U32 sequence)
+	{
+		return (sequence * 2654435761U) >> (32 - HASH_BITS);
+	}
+
+	static U8* writeLength(U8* op, U32 length)
+	{
+		while (length >= 0xFF) {
+			*op++ = 0xFF;
+			length -= 0xFF;
+		}
+		*op++ = static_cast<U8>(length);
+		return op;
+	}
+
+	static BIT readLength(const U8*& ip, const U8* ipEnd, U32& length)
+	{
+		U8 byte = 0;
+		do {
+			if (ip >= ipEnd) return ESX_FALSE;
+			byte = *ip++;
+			length += byte;
+		} while (byte == 0xFF);
+		return ESX_TRUE;
+	}
+
+	U32 CompressBlock(const U8* src, U32 size, U8* dst, U32 capacity)
+	{
+		const U8* ip = src;
+		const U8* anchor = src;
+		const U8* end = src + size;
+		const U8* matchLimit = end - LAST_LITERALS;
+		U8* op = dst;
+		U8* opEnd = dst + capacity;
+
+		//Emits the literals since anchor, followed by a match unless it is the closing sequence
+		auto emit = [&](U32 literals, U32 offset, U32 matchLength, BIT last) {
+			U64 needed = 1 + literals + literals / 0xFF + 1 + (last ? 0 : 2 + matchLength / 0xFF + 1);
+			if (needed > static_cast<U64>(opEnd - op)) return ESX_FALSE;
+
+			U8* token = op++;
+			*token = static_cast<U8>(std::min<U32>(literals, 0xF) << 4);
+			if (literals >= 0xF) op = writeLength(op, literals - 0xF);
+			std::memcpy(op, anchor, literals);
+			op += literals;
+
+			if (!last) {
+				*op++ = static_cast<U8>(offset & 0xFF);
+				*op++ = static_cast<U8>(offset >> 8);
+				*token |= static_cast<U8>(std::min<U32>(matchLength, 0xF));
+				if (matchLength >= 0xF) op = writeLength(op, matchLength - 0xF);
+			}
+			return ESX_TRUE;
+		};
+
+		if (size >= MATCH_START_LIMIT) {
+			Array<U32, 1 << HASH_BITS> table = {};
+			const U8* matchStartLimit = end - MATCH_START_LIMIT;
+
+			table[hash(read32(ip))] = 0;
+			ip++;
+
+			while (ip <= matchStartLimit) {
+				U32 sequence = read32(ip);
+				U32& slot = table[hash(sequence)];
+				const U8* ref = src + slot;
+				slot = static_cast<U32>(ip - src);
+
+				if (ref >= ip || static_cast<U32>(ip - ref) > MAX_OFFSET || read32(ref) != sequence) {
+					ip++;
+					continue;
+				}
+
+				while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+					ip--;
+					ref--;
+				}
+
+				const U8* matchEnd = ip + MIN_MATCH;
+				const U8* refEnd = ref + MIN_MATCH;
+				while (matchEnd < matchLimit && *matchEnd == *refEnd) {
+					matchEnd++;
+					refEnd++;
+				}
+
+				if (!emit(static_cast<U32>(ip - anchor), static_cast<U32>(ip - ref), static_cast<U32>(matchEnd - ip) - MIN_MATCH, ESX_FALSE)) return 0;
+
+				ip = matchEnd;
+				anchor = ip;
+			}
+		}
+
+		if (!emit(static_cast<U32>(end - anchor), 0, 0, ESX_TRUE)) return 0;
+
+		return static_cast<U32>(op - dst);
+	}
+
+	BIT DecompressBlock(const U8* src, U32 size, U8* dst, U32 dstSize)
+	{
+		const U8* ip = src;
+		const U8* ipEnd = src + size;
+		U8* op = dst;
+		U8* opEnd = dst + dstSize;
+
+		while (ip < ipEnd) {
+			U8 token = *ip++;
+
+			U32 literals = token >> 4;
+			if (literals == 0xF && !readLength(ip, ipEnd, literals)) return ESX_FALSE;
+			if (literals > static_cast<U64>(ipEnd - ip) || literals > static_cast<U64>(opEnd - op)) return ESX_FALSE;
+
+			std::memcpy(op, ip, literals);
+			ip += literals;
+			op += literals;
+
+			//The closing sequence has no match
+			if (ip == ipEnd) break;
+
+			if (ipEnd - ip < 2) return ESX_FALSE;
+			U32 offset = ip[0] | (ip[1] << 8);
+			ip += 2;
+			if (offset == 0 || offset > static_cast<U64>(op - dst)) return ESX_FALSE;
+
+			U32 matchLength = token & 0xF;
+			if (matchLength == 0xF && !readLength(ip, ipEnd, matchLength)) return ESX_FALSE;
+			matchLength += MIN_MATCH;
+			if (matchLength > static_cast<U64>(opEnd - op)) return ESX_FALSE;
+
+			//Byte by byte, overlapping matches repeat the pattern
+			const U8* match = op - offset;
+			for (U32 i = 0; i < matchLength; i++) {
+				op[i] = match[i];
+			}
+			op += matchLength;
+		}
+
+		return op == opEnd;
+	}
+
+}
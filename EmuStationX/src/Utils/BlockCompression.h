@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Base/Base.h"
+
+namespace esx {
+
+	//Small in-tree codec for independently compressed blocks, in the LZ4 block format so an LZ4 build can
+	//read and write the same data. Greedy single probe matcher, compression ratio is traded for speed.
+
+	//Returns the compressed size, 0 when the result does not fit in capacity
+	U32 CompressBlock(const U8* src, U32 size, U8* dst, U32 capacity);
+
+	//dst must be exactly the uncompressed size, malformed input is rejected instead of overrunning either buffer
+	BIT DecompressBlock(const U8* src, U32 size, U8* dst, U32 dstSize);
+
+	constexpr U32 CompressBlockBound(U32 size) { return size + size / 255 + 16; }
+
+}
@@ -74,4 +74,91 @@ namespace esx {
         // Nessun asse di separazione trovato, quindi i triangoli si sovrappongono
         return ESX_TRUE;
     }
+
+    BoundingBox getBoundingBox(const Vertex& a, const Vertex& b, const Vertex& c) {
+        BoundingBox box = {};
+        box.MinX = std::min({ a.x, b.x, c.x });
+        box.MinY = std::min({ a.y, b.y, c.y });
+        box.MaxX = std::max({ a.x, b.x, c.x });
+        box.MaxY = std::max({ a.y, b.y, c.y });
+        return box;
+    }
+
+    void TriangleGrid::clear() {
+        if (mTriangles.empty()) return;
+
+        for (Vector<U32>& cell : mCells) {
+            cell.clear();
+        }
+        mTriangles.clear();
+    }
+
+    void TriangleGrid::insert(const Vertex& a, const Vertex& b, const Vertex& c) {
+        U32 index = (U32)mTriangles.size();
+        BoundingBox box = getBoundingBox(a, b, c);
+        mTriangles.push_back(Triangle{ a, b, c, box, mQuery });
+
+        I32 minColumn, minRow, maxColumn, maxRow;
+        getCellRange(box, minColumn, minRow, maxColumn, maxRow);
+        for (I32 row = minRow; row <= maxRow; row++) {
+            for (I32 column = minColumn; column <= maxColumn; column++) {
+                mCells[row * VRAM_CELL_COLUMNS + column].push_back(index);
+            }
+        }
+    }
+
+    BIT TriangleGrid::overlaps(const Vertex& a, const Vertex& b, const Vertex& c) {
+        BoundingBox box = getBoundingBox(a, b, c);
+        mQuery++;
+
+        I32 minColumn, minRow, maxColumn, maxRow;
+        getCellRange(box, minColumn, minRow, maxColumn, maxRow);
+        for (I32 row = minRow; row <= maxRow; row++) {
+            for (I32 column = minColumn; column <= maxColumn; column++) {
+                for (U32 index : mCells[row * VRAM_CELL_COLUMNS + column]) {
+                    Triangle& triangle = mTriangles[index];
+
+                    // Triangles spanning several cells are tested only once per query
+                    if (triangle.LastQuery == mQuery) continue;
+                    triangle.LastQuery = mQuery;
+
+                    if (box.overlaps(triangle.Box) && checkOverlap(a, b, c, triangle.A, triangle.B, triangle.C)) {
+                        return ESX_TRUE;
+                    }
+                }
+            }
+        }
+
+        return ESX_FALSE;
+    }
+
+    void TileMask::mark(const BoundingBox& box) {
+        I32 minColumn, minRow, maxColumn, maxRow;
+        getCellRange(box, minColumn, minRow, maxColumn, maxRow);
+
+        U16 columns = (U16)(((1 << (maxColumn + 1)) - 1) & ~((1 << minColumn) - 1));
+        for (I32 row = minRow; row <= maxRow; row++) {
+            mRows[row] |= columns;
+        }
+    }
+
+    BIT TileMask::test(const BoundingBox& box) const {
+        I32 minColumn, minRow, maxColumn, maxRow;
+        getCellRange(box, minColumn, minRow, maxColumn, maxRow);
+
+        U16 columns = (U16)(((1 << (maxColumn + 1)) - 1) & ~((1 << minColumn) - 1));
+        for (I32 row = minRow; row <= maxRow; row++) {
+            if (mRows[row] & columns) return ESX_TRUE;
+        }
+
+        return ESX_FALSE;
+    }
+
+    void getCellRange(const BoundingBox& box, I32& minColumn, I32& minRow, I32& maxColumn, I32& maxRow) {
+        // Clamping keeps intersecting boxes in shared cells, even outside of VRAM
+        minColumn = std::clamp(box.MinX / VRAM_CELL_WIDTH, 0, VRAM_CELL_COLUMNS - 1);
+        maxColumn = std::clamp(box.MaxX / VRAM_CELL_WIDTH, 0, VRAM_CELL_COLUMNS - 1);
+        minRow = std::clamp(box.MinY / VRAM_CELL_HEIGHT, 0, VRAM_CELL_ROWS - 1);
+        maxRow = std::clamp(box.MaxY / VRAM_CELL_HEIGHT, 0, VRAM_CELL_ROWS - 1);
+    }
 }
\ No newline at end of file
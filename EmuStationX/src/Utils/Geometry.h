@@ -19,4 +19,67 @@ namespace esx {
 
     // Funzione principale per verificare la sovrapposizione tra due triangoli
     bool checkOverlap(const Vertex& triA_a, const Vertex& triA_b, const Vertex& triA_c, const Vertex& triB_a, const Vertex& triB_b, const Vertex& triB_c);
+
+    struct BoundingBox {
+        I32 MinX = 0;
+        I32 MinY = 0;
+        I32 MaxX = 0;
+        I32 MaxY = 0;
+
+        BIT overlaps(const BoundingBox& other) const {
+            return !(MaxX < other.MinX || other.MaxX < MinX || MaxY < other.MinY || other.MaxY < MinY);
+        }
+
+        BIT contains(const BoundingBox& other) const {
+            return other.MinX >= MinX && other.MaxX <= MaxX && other.MinY >= MinY && other.MaxY <= MaxY;
+        }
+
+        BIT empty() const {
+            return MinX > MaxX || MinY > MaxY;
+        }
+    };
+
+    BoundingBox getBoundingBox(const Vertex& a, const Vertex& b, const Vertex& c);
+
+    // VRAM space is split in 64x32 cells for the spatial structures below
+    constexpr I32 VRAM_CELL_WIDTH = 64;
+    constexpr I32 VRAM_CELL_HEIGHT = 32;
+    constexpr I32 VRAM_CELL_COLUMNS = 1024 / VRAM_CELL_WIDTH;
+    constexpr I32 VRAM_CELL_ROWS = 512 / VRAM_CELL_HEIGHT;
+
+    void getCellRange(const BoundingBox& box, I32& minColumn, I32& minRow, I32& maxColumn, I32& maxRow);
+
+    // Uniform grid over VRAM space, only triangles sharing a cell get the exact overlap test
+    class TriangleGrid {
+    public:
+        void clear();
+        void insert(const Vertex& a, const Vertex& b, const Vertex& c);
+        BIT overlaps(const Vertex& a, const Vertex& b, const Vertex& c);
+
+        size_t size() const { return mTriangles.size(); }
+
+    private:
+        struct Triangle {
+            Vertex A;
+            Vertex B;
+            Vertex C;
+            BoundingBox Box;
+            U32 LastQuery;
+        };
+
+        Array<Vector<U32>, VRAM_CELL_COLUMNS * VRAM_CELL_ROWS> mCells = {};
+        Vector<Triangle> mTriangles = {};
+        U32 mQuery = 0;
+    };
+
+    // One bit per VRAM cell, used to track which areas were touched by a batch
+    class TileMask {
+    public:
+        void clear() { mRows = {}; }
+        void mark(const BoundingBox& box);
+        BIT test(const BoundingBox& box) const;
+
+    private:
+        Array<U16, VRAM_CELL_ROWS> mRows = {};
+    };
 }
\ No newline at end of file
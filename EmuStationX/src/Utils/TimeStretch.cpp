@@ -0,0 +1,131 @@
+#include "TimeStretch.h"
+
+#include <cmath>
+
+namespace esx {
+
+	void TimeStretch::setEnabled(BIT enabled)
+	{
+		mEnabled = enabled;
+
+		mInput.clear();
+		mMono.clear();
+		mPosition = SEEK;
+		mHasTail = ESX_FALSE;
+
+		mTempo = 1.0;
+		mMeasuredFrames = 0;
+		mMeasureStart = std::chrono::steady_clock::now();
+	}
+
+	void TimeStretch::push(const AudioFrame& frame, AudioRing& output)
+	{
+		if (!mEnabled) {
+			output.push(frame);
+			return;
+		}
+
+		mInput.push_back(frame);
+		mMono.push_back(static_cast<F32>(frame.Left) + static_cast<F32>(frame.Right));
+		measureTempo();
+
+		//A segment needs its whole search range and the tail that follows it
+		while (mInput.size() >= static_cast<U32>(mPosition) + SEEK + HOP + OVERLAP) {
+			processSegment(output);
+		}
+	}
+
+	void TimeStretch::measureTempo()
+	{
+		mMeasuredFrames++;
+		if ((mMeasuredFrames & 0x3FF) != 0) return;
+
+		auto now = std::chrono::steady_clock::now();
+		F64 elapsed = std::chrono::duration<F64>(now - mMeasureStart).count();
+		if (elapsed < 0.1) return;
+
+		//Long gaps are pauses, not a slow down
+		if (elapsed < 1.0) {
+			F64 rate = mMeasuredFrames / (elapsed * SAMPLE_RATE);
+			mTempo = std::clamp(mTempo + (rate - mTempo) * 0.5, 1.0, MAX_TEMPO);
+		}
+
+		mMeasuredFrames = 0;
+		mMeasureStart = now;
+	}
+
+	void TimeStretch::processSegment(AudioRing& output)
+	{
+		U32 start = mHasTail ? findBestOffset(static_cast<U32>(mPosition)) : static_cast<U32>(mPosition);
+
+		for (U32 i = 0; i < HOP; i++) {
+			AudioFrame frame = mInput[start + i];
+			if (mHasTail && i < OVERLAP) {
+				F32 weight = (i + 0.5f) / OVERLAP;
+				frame.Left = static_cast<I16>(mTail[i].Left + (frame.Left - mTail[i].Left) * weight);
+				frame.Right = static_cast<I16>(mTail[i].Right + (frame.Right - mTail[i].Right) * weight);
+			}
+			output.push(frame);
+		}
+
+		//What would have followed the segment is what the next one has to blend into
+		for (U32 i = 0; i < OVERLAP; i++) {
+			mTail[i] = mInput[start + HOP + i];
+			mTailMono[i] = mMono[start + HOP + i];
+		}
+		mHasTail = ESX_TRUE;
+
+		//The ring fill trims the measured tempo so estimation errors do not build up as latency
+		F64 fill = (static_cast<F64>(output.size()) - AudioRing::TARGET_FILL) / AudioRing::TARGET_FILL;
+		mPosition += HOP * mTempo * std::clamp(1.0 + fill * 0.25, 0.8, 1.25);
+
+		U32 consumed = static_cast<U32>(mPosition) - SEEK;
+		if (consumed >= HOP) {
+			consumed = std::min<U32>(consumed, static_cast<U32>(mInput.size()));
+			mInput.erase(mInput.begin(), mInput.begin() + consumed);
+			mMono.erase(mMono.begin(), mMono.begin() + consumed);
+			mPosition -= consumed;
+		}
+	}
+
+	U32 TimeStretch::findBestOffset(U32 nominal) const
+	{
+		//Coarse search over the whole range, then refine around the best coarse match
+		U32 best = nominal;
+		F32 bestSimilarity = getSimilarity(nominal);
+
+		for (U32 start = nominal - SEEK; start <= nominal + SEEK; start += 4) {
+			F32 similarity = getSimilarity(start);
+			if (similarity > bestSimilarity) {
+				bestSimilarity = similarity;
+				best = start;
+			}
+		}
+
+		U32 coarse = best;
+		for (U32 start = std::max(coarse, nominal - SEEK + 3) - 3; start <= std::min(coarse + 3, nominal + SEEK); start++) {
+			F32 similarity = getSimilarity(start);
+			if (similarity > bestSimilarity) {
+				bestSimilarity = similarity;
+				best = start;
+			}
+		}
+
+		return best;
+	}
+
+	F32 TimeStretch::getSimilarity(U32 start) const
+	{
+		F32 correlation = 0.0f;
+		F32 energy = 1.0f;
+
+		const F32* samples = &mMono[start];
+		for (U32 i = 0; i < OVERLAP; i++) {
+			correlation += samples[i] * mTailMono[i];
+			energy += samples[i] * samples[i];
+		}
+
+		return correlation / std::sqrt(energy);
+	}
+
+}
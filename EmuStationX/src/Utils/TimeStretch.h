@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Base/Base.h"
+#include "Base/CDBase.h"
+
+#include "Utils/AudioRing.h"
+
+#include <chrono>
+
+namespace esx {
+
+	//WSOLA time compressor between the SPU and the audio ring, used while emulation runs faster than real time.
+	//Input segments are picked HOP * tempo frames apart and nudged by up to SEEK frames to line up with the
+	//previous segment, so the pitch stays the same while the output rate drops back to SAMPLE_RATE.
+	class TimeStretch {
+	public:
+		TimeStretch() = default;
+		~TimeStretch() = default;
+
+		void setEnabled(BIT enabled);
+		BIT isEnabled() const { return mEnabled; }
+
+		//Producer side, the tempo is measured from the rate frames are pushed at
+		void push(const AudioFrame& frame, AudioRing& output);
+
+		F64 getTempo() const { return mTempo; }
+
+	public:
+		static constexpr U32 SAMPLE_RATE = 44100;
+		static constexpr U32 HOP = 512;
+		static constexpr U32 OVERLAP = 256;
+		static constexpr U32 SEEK = 256;
+		static constexpr F64 MAX_TEMPO = 64.0;
+
+	private:
+		void measureTempo();
+		void processSegment(AudioRing& output);
+		U32 findBestOffset(U32 nominal) const;
+		F32 getSimilarity(U32 start) const;
+
+	private:
+		BIT mEnabled = ESX_FALSE;
+
+		Vector<AudioFrame> mInput = {};
+		Vector<F32> mMono = {};
+		F64 mPosition = 0.0;
+
+		Array<AudioFrame, OVERLAP> mTail = {};
+		Array<F32, OVERLAP> mTailMono = {};
+		BIT mHasTail = ESX_FALSE;
+
+		F64 mTempo = 1.0;
+		U32 mMeasuredFrames = 0;
+		std::chrono::steady_clock::time_point mMeasureStart = {};
+	};
+
+}
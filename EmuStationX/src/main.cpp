@@ -59,6 +59,8 @@
 
 #include "Platform/Win32/CDROMDrive.h"
 #include "Core/CD/CDROMDisk.h"
+#include "Core/CD/PrefetchDisk.h"
+#include "Core/CD/CompressedDisc.h"
 
 
 
@@ -325,6 +327,10 @@ public:
 		   }},
 		   { ".iso", [&](const std::filesystem::path& filePath) {
 			   return MakeShared<ISO>(filePath);
+		   }},
+		   { ".esxz", [&](const std::filesystem::path& filePath) -> SharedPtr<CompactDisk> {
+			   auto disc = MakeShared<CompressedDisc>(filePath);
+			   return disc->isOpen() ? disc : nullptr;
 		   }}
 		};
 
@@ -332,10 +338,15 @@ public:
 		if (handlers.contains(extension)) {
 			auto cd = handlers[extension](filePath);
 			if (cd) {
-				cdrom->insertCD(cd);
-				mISO9660 = MakeShared<ISO9660>(cd);
+				//Mapped images are paged in by the OS, only streamed ones need the read-ahead thread
+				if (mDiscPreload == DiscPreload::Off && !cd->providesSectorViews()) {
+					cd = MakeShared<PrefetchDisk>(cd);
+				}
+				cdrom->insertCD(cd, mDiscPreload);
+				mISO9660 = MakeShared<ISO9660>(cdrom->getCD());
 				mISOBrowser->setInstance(mISO9660);
 				mCurrentGame = getBootNameFromSystemConfig();
+				mDiscPath = filePath;
 			}
 			hardReset();
 			ESX_CORE_LOG_INFO("File {} loaded", filePath.stem().string());
@@ -351,15 +362,7 @@ public:
 		}
 
 		EmuStationXApp* pApp = (EmuStationXApp*)pDevice->pUserData;
-		auto spu = pApp->spu;
-
-		std::scoped_lock<std::mutex> lc(spu->mSamplesMutex);
-		if (spu->mFrontBuffer.Complete() == ESX_FALSE) {
-			return;
-		}
-
-		std::memcpy(pOutput, spu->mFrontBuffer.Batch.data(), sizeof(AudioFrame) * frameCount);
-			
+		pApp->spu->mAudioRing.read(reinterpret_cast<AudioFrame*>(pOutput), frameCount);
 
 		/*if (pApp->mNumPrerendered < pApp->PRERENDERED_SIZE) {
 			auto& batch = spu->mFramesQueue.front();
@@ -426,6 +429,7 @@ public:
 
 	virtual void onCleanUp() override {
 		ma_device_uninit(&mAudioDevice);
+		if (mCompressThread.joinable()) mCompressThread.join();
 	}
 
 	virtual void onImGuiRender(const SharedPtr<ImGuiManager>& pManager, const SharedPtr<Window>& pWindow) override {
@@ -463,6 +467,38 @@ public:
 				if (ImGui::MenuItem("Memory", "CTRL+M")) mMemoryEditorPanel->open();
 				if (ImGui::MenuItem("Console", "CTRL+O")) mConsolePanel->open();
 
+				ImGui::Separator();
+
+				if (ImGui::MenuItem("Record MDEC Stream", nullptr, mdec->isRecording())) {
+					if (mdec->isRecording()) mdec->stopRecording();
+					else mdec->startRecording("mdec_stream.bin");
+				}
+				if (ImGui::MenuItem("MDEC Benchmark", nullptr, false, !mdec->isRecording())) runMDECBenchmark("mdec_stream.bin");
+				if (ImGui::MenuItem("Compress Disc Image", nullptr, false, !mCompressing && mDiscPath.extension() == ".cue")) {
+					compressDisc(mDiscPath, std::filesystem::path(mDiscPath).replace_extension(".esxz"));
+				}
+
+				ImGui::Separator();
+
+				if (ImGui::MenuItem("Capture Audio", nullptr, spu->mMixCapture.isActive())) toggleCapture(spu->mMixCapture, "audio_capture.wav");
+				if (ImGui::MenuItem("Capture CD Audio", nullptr, spu->mCDCapture.isActive())) toggleCapture(spu->mCDCapture, "cd_capture.wav");
+				if (ImGui::BeginMenu("Capture Voice"))
+				{
+					for (U8 voice = 0; voice < 24; voice++) {
+						std::string label = "Voice " + std::to_string(voice);
+						BIT capturing = spu->mVoiceCapture.isActive() && spu->mCaptureVoice == voice;
+						if (ImGui::MenuItem(label.c_str(), nullptr, capturing)) {
+							spu->mVoiceCapture.stop();
+							if (!capturing) {
+								spu->mCaptureVoice = voice;
+								spu->mVoiceCapture.start("voice_" + std::to_string(voice) + "_capture.wav");
+							}
+						}
+					}
+
+					ImGui::EndMenu();
+				}
+
 				ImGui::EndMenu();
 			}
 
@@ -471,6 +507,45 @@ public:
 				if (ImGui::MenuItem("Play")) mDisassemblerPanel->onPlay();
 				if (ImGui::MenuItem("Pause")) mDisassemblerPanel->onPause();
 				if (ImGui::MenuItem("Hard Reset")) hardReset();
+				if (ImGui::MenuItem("Texture Cache", nullptr, mBatchRenderer->isTextureCacheEnabled())) mBatchRenderer->setTextureCacheEnabled(!mBatchRenderer->isTextureCacheEnabled());
+				if (ImGui::MenuItem("MDEC Worker Thread", nullptr, mdec->isPipelined())) mdec->setPipelined(!mdec->isPipelined());
+
+				if (ImGui::BeginMenu("Speed"))
+				{
+					EmulationSpeed speed = mDisassemblerPanel->getSpeed();
+
+					if (ImGui::MenuItem("Normal", nullptr, speed == EmulationSpeed::Normal)) setEmulationSpeed(EmulationSpeed::Normal);
+					if (ImGui::MenuItem("Turbo 2x", nullptr, speed == EmulationSpeed::Turbo2x)) setEmulationSpeed(EmulationSpeed::Turbo2x);
+					if (ImGui::MenuItem("Turbo 4x", nullptr, speed == EmulationSpeed::Turbo4x)) setEmulationSpeed(EmulationSpeed::Turbo4x);
+					if (ImGui::MenuItem("Uncapped", nullptr, speed == EmulationSpeed::Uncapped)) setEmulationSpeed(EmulationSpeed::Uncapped);
+
+					ImGui::EndMenu();
+				}
+
+				if (ImGui::BeginMenu("Frame Skip"))
+				{
+					FrameSkipMode mode = gpu->getFrameSkipMode();
+					U32 frames = gpu->getFrameSkip();
+
+					if (ImGui::MenuItem("Off", nullptr, mode == FrameSkipMode::Off)) gpu->setFrameSkip(FrameSkipMode::Off, frames);
+					if (ImGui::MenuItem("Auto", nullptr, mode == FrameSkipMode::Auto)) gpu->setFrameSkip(FrameSkipMode::Auto, 3);
+					for (U32 n = 1; n <= 3; n++) {
+						std::string label = "Skip " + std::to_string(n);
+						if (ImGui::MenuItem(label.c_str(), nullptr, mode == FrameSkipMode::Fixed && frames == n)) gpu->setFrameSkip(FrameSkipMode::Fixed, n);
+					}
+
+					ImGui::EndMenu();
+				}
+
+				//Applies to the next disc that gets loaded
+				if (ImGui::BeginMenu("Disc Preload"))
+				{
+					if (ImGui::MenuItem("Off", nullptr, mDiscPreload == DiscPreload::Off)) mDiscPreload = DiscPreload::Off;
+					if (ImGui::MenuItem("Background", nullptr, mDiscPreload == DiscPreload::Background)) mDiscPreload = DiscPreload::Background;
+					if (ImGui::MenuItem("Synchronous", nullptr, mDiscPreload == DiscPreload::Synchronous)) mDiscPreload = DiscPreload::Synchronous;
+
+					ImGui::EndMenu();
+				}
 
 				ImGui::EndMenu();
 			}
@@ -490,6 +565,8 @@ public:
 
 			ImGui::TextUnformatted(mCurrentGame.c_str());
 
+			if (mCompressing) ImGui::Text("Compressing Disc: %.0f%%", mCompressProgress.load() * 100.0f);
+
 			ImGui::EndMenuBar();
 		}
 
@@ -511,6 +588,18 @@ public:
 		mISOBrowser->render(pManager);
 	}
 
+	void compressDisc(const std::filesystem::path& cuePath, const std::filesystem::path& outPath) {
+		//Converting a whole disc takes seconds, it runs on its own thread so the UI keeps drawing the progress
+		if (mCompressThread.joinable()) mCompressThread.join();
+
+		mCompressProgress = 0.0f;
+		mCompressing = ESX_TRUE;
+		mCompressThread = std::thread([this, cuePath, outPath]() {
+			CompressedDisc::Convert(cuePath, outPath, CompressedDisc::DEFAULT_HUNK_SECTORS, &mCompressProgress);
+			mCompressing = ESX_FALSE;
+		});
+	}
+
 	void hardReset() {
 		fpsCounter.Init();
 		cpu->reset();
@@ -534,6 +623,64 @@ public:
 		}
 	}
 
+	void toggleCapture(AudioCapture& capture, const std::filesystem::path& path) {
+		if (capture.isActive()) capture.stop();
+		else capture.start(path);
+	}
+
+	void setEmulationSpeed(EmulationSpeed speed) {
+		mDisassemblerPanel->setSpeed(speed);
+
+		//Faster than real time audio is time compressed so it keeps its pitch
+		spu->mTimeStretch.setEnabled(speed != EmulationSpeed::Normal);
+	}
+
+	void runMDECBenchmark(const std::filesystem::path& path) {
+		constexpr U32 ITERATIONS = 10;
+		constexpr Array<const char*, 4> DEPTH_NAMES = { "4-bit", "8-bit", "24-bit", "15-bit" };
+
+		//Without expected hashes the first inline run becomes the reference for the following ones
+		std::filesystem::path hashPath = MDEC::GetBenchmarkHashPath(path);
+		Optional<MDECBenchmarkResult> expected = MDEC::LoadBenchmarkHashes(hashPath);
+		BIT passed = ESX_TRUE;
+
+		for (BIT pipelined : { ESX_FALSE, ESX_TRUE }) {
+			Optional<MDECBenchmarkResult> result = MDEC::Benchmark(path, ITERATIONS, pipelined);
+			if (!result) return;
+
+			if (result->KernelsCompared && result->KernelMismatches > 0) {
+				ESX_CORE_LOG_ERROR("MDEC Benchmark - SIMD output differs from the scalar reference in {} blocks", result->KernelMismatches);
+				passed = ESX_FALSE;
+			}
+
+			F64 macroblocksPerSecond = result->Seconds > 0.0 ? result->Macroblocks / result->Seconds : 0.0;
+			ESX_CORE_LOG_INFO("MDEC Benchmark - {} - {} macroblocks in {:.3f}s, {:.0f} macroblocks/s", pipelined ? "pipelined" : "inline", result->Macroblocks, result->Seconds, macroblocksPerSecond);
+
+			if (!expected) {
+				ESX_CORE_LOG_INFO("MDEC Benchmark - No expected hashes, saving these to {}", hashPath.string());
+				MDEC::SaveBenchmarkHashes(hashPath, *result);
+				expected = result;
+			}
+
+			for (U32 depth = 0; depth < 4; depth++) {
+				if (result->DepthMacroblocks[depth] == 0 && expected->DepthMacroblocks[depth] == 0) continue;
+
+				if (result->DepthMacroblocks[depth] != expected->DepthMacroblocks[depth] || result->DepthHashes[depth] != expected->DepthHashes[depth]) {
+					ESX_CORE_LOG_ERROR("MDEC Benchmark - {} - {} macroblocks hash {:016x}, expected {} macroblocks hash {:016x}", DEPTH_NAMES[depth], result->DepthMacroblocks[depth], result->DepthHashes[depth], expected->DepthMacroblocks[depth], expected->DepthHashes[depth]);
+					passed = ESX_FALSE;
+				} else {
+					ESX_CORE_LOG_INFO("MDEC Benchmark - {} - {} macroblocks hash {:016x}", DEPTH_NAMES[depth], result->DepthMacroblocks[depth], result->DepthHashes[depth]);
+				}
+			}
+		}
+
+		if (passed) {
+			ESX_CORE_LOG_INFO("MDEC Benchmark - Passed");
+		} else {
+			ESX_CORE_LOG_ERROR("MDEC Benchmark - FAILED, decoded output does not match");
+		}
+	}
+
 private:
 	SharedPtr<Controller> controller;
 	SharedPtr<MemoryCard> memoryCard, memoryCard2;
@@ -578,6 +725,12 @@ private:
 	SharedPtr<platform::CDROMDrive> mCDROMDrive;
 	SharedPtr<ISO9660> mISO9660;
 	String mCurrentGame = "";
+	std::filesystem::path mDiscPath = {};
+	DiscPreload mDiscPreload = DiscPreload::Off;
+
+	std::thread mCompressThread = {};
+	std::atomic<F32> mCompressProgress = 0.0f;
+	std::atomic<BIT> mCompressing = ESX_FALSE;
 };
 
 int